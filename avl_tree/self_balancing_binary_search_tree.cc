@@ -12,8 +12,11 @@ namespace s21 {
  * exists in the tree.
  */
 bool SelfBalancingBinarySearchTree::Set(const Key& key, const Value& value) {
-  if (FindNode(root_, key).has_value()) return false;
-  InsertHelper(root_, key, value);
+  Path path;
+  Index node = kNull;
+  std::size_t depth = Descend(key, path, node);
+  if (node != kNull) return false;
+  Attach(path, depth, NewNode(key, value));
   return true;
 }
 
@@ -26,12 +29,10 @@ bool SelfBalancingBinarySearchTree::Set(const Key& key, const Value& value) {
  * @return An optional value that is associated with the given key if it exists
  * in the tree, otherwise returns std::nullopt.
  */
-std::optional<Value> SelfBalancingBinarySearchTree::Get(const Key& key) const {
-  auto result = FindNode(root_, key);
-  if (result.has_value()) {
-    return result.value()->value;
-  }
-  return std::nullopt;
+std::optional<Value> SelfBalancingBinarySearchTree::Get(KeyView key) const {
+  Index node = FindNode(key);
+  if (node == kNull) return std::nullopt;
+  return values_[node];
 }
 
 /**
@@ -41,8 +42,8 @@ std::optional<Value> SelfBalancingBinarySearchTree::Get(const Key& key) const {
  *
  * @return true if the key exists in the tree, false otherwise
  */
-bool SelfBalancingBinarySearchTree::Exists(const Key& key) const {
-  return FindNode(root_, key).has_value();
+bool SelfBalancingBinarySearchTree::Exists(KeyView key) const {
+  return FindNode(key) != kNull;
 }
 
 /**
@@ -53,124 +54,186 @@ bool SelfBalancingBinarySearchTree::Exists(const Key& key) const {
  *
  * @return true if the node was successfully deleted, false otherwise
  */
-bool SelfBalancingBinarySearchTree::Del(const Key& key) {
-  if (!FindNode(root_, key).has_value()) return false;
-  root_ = DeletHelper(std::move(root_), key);
+bool SelfBalancingBinarySearchTree::Del(KeyView key) {
+  Path path;
+  Index node = kNull;
+  std::size_t depth = Descend(key, path, node);
+  if (node == kNull) return false;
+  Detach(path, depth, node);
+  FreeNode(node);
   return true;
 }
 
 /**
- * @brief Finds the minimum value in a self-balancing binary search tree.
+ * @brief Find a node with the given key in the self-balancing binary search
+ * tree.
  *
- * @param node a pointer to the root node of the tree
+ * @param key The key to search for.
  *
- * @return a const pointer to the node containing the minimum value
+ * @return The index of the node with the given key, or kNull if the key is not
+ * found.
  */
-const SelfBalancingBinarySearchTree::AVLNode*
-SelfBalancingBinarySearchTree::FindMin(const AVLNode* node) const {
-  while (node->left) {
-    node = node->left.get();
+SelfBalancingBinarySearchTree::Index SelfBalancingBinarySearchTree::FindNode(
+    KeyView key) const {
+  Index node = root_;
+  while (node != kNull) {
+    const AVLNode& current = nodes_[node];
+    if (current.key == key) break;
+    node = (key < current.key) ? current.left : current.right;
   }
   return node;
 }
 
 /**
- * @brief Deletes a node with the specified key from the self-balancing binary
- * search tree.
+ * @brief Walks down from the root towards the given key and records every
+ * node passed on the way.
  *
- * @param node A unique pointer to the root node of the tree.
- * @param key The key of the node to be deleted.
+ * @param key The key to search for.
+ * @param path Receives the visited nodes, from the root down.
+ * @param node Receives the index of the node with the key, or kNull.
  *
- * @return A unique pointer to the root node after the deletion.
+ * @return The number of nodes recorded in the path.
  */
-std::unique_ptr<SelfBalancingBinarySearchTree::AVLNode>
-SelfBalancingBinarySearchTree::DeletHelper(std::unique_ptr<AVLNode> node,
-                                           const Key& key) {
-  if (node == nullptr) return nullptr;
-  if (key < node->key) {
-    node->left = DeletHelper(std::move(node->left), key);
-  } else if (key > node->key) {
-    node->right = DeletHelper(std::move(node->right), key);
-  } else {
-    if (node->left == nullptr || node->right == nullptr) {
-      node = (node->left == nullptr) ? std::move(node->right)
-                                     : std::move(node->left);
-    } else {
-      const AVLNode* min_right = FindMin(node->right.get());
-      node->key = min_right->key;
-      node->value = min_right->value;
-      node->right = DeletHelper(std::move(node->right), min_right->key);
-    }
+std::size_t SelfBalancingBinarySearchTree::Descend(KeyView key, Path& path,
+                                                   Index& node) const {
+  std::size_t depth = 0;
+  node = root_;
+  while (node != kNull) {
+    const AVLNode& current = nodes_[node];
+    if (current.key == key) break;
+    path[depth++] = node;
+    node = (key < current.key) ? current.left : current.right;
+  }
+  return depth;
+}
+
+/**
+ * @brief Hangs a detached node below the last node of a path returned by
+ * Descend and rebalances the path bottom-up.
+ *
+ * @param path The path to the place of the node.
+ * @param depth The number of nodes in the path.
+ * @param node The index of a node with no children.
+ */
+void SelfBalancingBinarySearchTree::Attach(const Path& path, std::size_t depth,
+                                           Index node) {
+  if (depth == 0) {
+    root_ = node;
+    return;
   }
-  if (node != nullptr) {
-    UpdateHeight(node);
-    BalanceNode(node);
+  AVLNode& parent = nodes_[path[depth - 1]];
+  if (nodes_[node].key < parent.key) {
+    parent.left = node;
+  } else {
+    parent.right = node;
   }
-  return node;
+  Rebalance(path, depth);
 }
 
 /**
- * @brief Find a node with the given key in the self-balancing binary search
- * tree.
+ * @brief Unlinks a node from the tree and rebalances the path bottom-up.
  *
- * @param node A pointer to the root node of the tree to search.
- * @param key The key to search for.
+ * A node with two children is replaced by its in-order successor, which is
+ * relinked in place, so no key or value is moved. The successor inherits the
+ * height of the node, which lets Rebalance stop as soon as a subtree keeps its
+ * old height.
  *
- * @return An optional pointer to the node with the given key, or std::nullopt
- * if the key is not found.
+ * @param path The ancestors of the node, as returned by Descend.
+ * @param depth The number of nodes in the path.
+ * @param node The index of the node to unlink.
  */
-std::optional<SelfBalancingBinarySearchTree::AVLNode*>
-SelfBalancingBinarySearchTree::FindNode(const std::unique_ptr<AVLNode>& node,
-                                        const Key& key) const {
-  if (node == nullptr) return std::nullopt;
-  if (node->key == key) return node.get();
-  if (node->key > key) {
-    return FindNode(node->left, key);
+void SelfBalancingBinarySearchTree::Detach(Path& path, std::size_t depth,
+                                           Index node) {
+  Index left = nodes_[node].left;
+  Index right = nodes_[node].right;
+  if (left == kNull or right == kNull) {
+    Relink(path, depth, node, (left == kNull) ? right : left);
   } else {
-    return FindNode(node->right, key);
+    std::size_t slot = depth++;
+    Index successor = right;
+    while (nodes_[successor].left != kNull) {
+      path[depth++] = successor;
+      successor = nodes_[successor].left;
+    }
+    if (successor != right) {
+      nodes_[path[depth - 1]].left = nodes_[successor].right;
+      nodes_[successor].right = right;
+    }
+    nodes_[successor].left = left;
+    nodes_[successor].height = nodes_[node].height;
+    Relink(path, slot, node, successor);
+    path[slot] = successor;
   }
+  nodes_[node].left = kNull;
+  nodes_[node].right = kNull;
+  nodes_[node].size = 1;
+  nodes_[node].height = 0;
+  Rebalance(path, depth);
 }
 
 /**
- * @brief Recursively inserts a new node with the given key and value into the
- * self-balancing binary search tree.
+ * @brief Points the parent of a node, or the root, at another node.
  *
- * @param node A reference to a unique pointer to an AVLNode representing
- *             the root node of the tree or subtree.
- * @param key The key of the new node to be inserted.
- * @param value The value of the new node to be inserted.
+ * @param path The ancestors of the node.
+ * @param depth The number of nodes in the path.
+ * @param old_child The index of the node being replaced.
+ * @param new_child The index of the node taking its place, may be kNull.
  */
-void SelfBalancingBinarySearchTree::InsertHelper(std::unique_ptr<AVLNode>& node,
-                                                 const Key& key,
-                                                 const Value& value) {
-  if (node == nullptr) {
-    node = std::make_unique<AVLNode>(key, value);
+void SelfBalancingBinarySearchTree::Relink(const Path& path, std::size_t depth,
+                                           Index old_child, Index new_child) {
+  if (depth == 0) {
+    root_ = new_child;
     return;
   }
-  if (key < node->key) {
-    InsertHelper(node->left, key, value);
+  AVLNode& parent = nodes_[path[depth - 1]];
+  if (parent.left == old_child) {
+    parent.left = new_child;
   } else {
-    InsertHelper(node->right, key, value);
+    parent.right = new_child;
+  }
+}
+
+/**
+ * @brief Updates heights and restores balance along a path, from the bottom
+ * up.
+ *
+ * Once a subtree keeps its old height nothing above it needs rebalancing, and
+ * the rest of the walk only adjusts the subtree sizes.
+ *
+ * @param path The nodes to rebalance, from the root down.
+ * @param depth The number of nodes in the path.
+ */
+void SelfBalancingBinarySearchTree::Rebalance(const Path& path,
+                                              std::size_t depth) {
+  bool settled = false;
+  while (depth-- > 0) {
+    Index node = path[depth];
+    if (settled) {
+      UpdateSize(node);
+      continue;
+    }
+    int old_height = nodes_[node].height;
+    UpdateNode(node);
+    Index top = BalanceNode(node);
+    if (top != node) Relink(path, depth, node, top);
+    settled = nodes_[top].height == old_height;
   }
-  UpdateHeight(node);
-  BalanceNode(node);
 }
 
 /**
  * @brief Perform an in-order traversal of a self-balancing binary search tree.
  *
- * @param node A pointer to the root node of the tree.
+ * @param node The index of the root node of the tree.
  * @param keys A vector to store the keys of the nodes in the tree.
  * @param values A vector to store the values of the nodes in the tree.
  */
 void SelfBalancingBinarySearchTree::InOrderTraversal(
-    const std::unique_ptr<AVLNode>& node, std::vector<Key>& keys,
-    std::vector<Value>& values) const {
-  if (node == nullptr) return;
-  InOrderTraversal(node->left, keys, values);
-  keys.push_back(node->key);
-  values.push_back(node->value);
-  InOrderTraversal(node->right, keys, values);
+    Index node, std::vector<Key>& keys, std::vector<Value>& values) const {
+  if (node == kNull) return;
+  InOrderTraversal(nodes_[node].left, keys, values);
+  keys.push_back(nodes_[node].key);
+  values.push_back(values_[node]);
+  InOrderTraversal(nodes_[node].right, keys, values);
 }
 
 /**
@@ -185,6 +248,209 @@ std::vector<Key> SelfBalancingBinarySearchTree::Keys() const {
   return vec_keys;
 }
 
+/**
+ * @brief Returns up to count keys in ascending order, starting after the key
+ * stored in the cursor.
+ *
+ * The walk descends once from the root to the first key after the cursor and
+ * then continues in order with an explicit stack, so a call costs
+ * O(log n + count) regardless of the size of the tree.
+ *
+ * @param cursor An empty string to start, or a cursor returned by Scan.
+ * @param count The maximum number of keys to return.
+ * @return The keys and the cursor of the next batch, empty at the end.
+ */
+AbstractStore::ScanResult SelfBalancingBinarySearchTree::Scan(
+    const std::string& cursor, std::size_t count) const {
+  if (count == 0) count = 1;
+  std::optional<Key> after;
+  if (!cursor.empty()) after = ParseKeyCursor(cursor);
+
+  std::vector<Index> stack;
+  for (Index node = root_; node != kNull;) {
+    if (!after.has_value() or nodes_[node].key > *after) {
+      stack.push_back(node);
+      node = nodes_[node].left;
+    } else {
+      node = nodes_[node].right;
+    }
+  }
+
+  ScanResult result;
+  CollectInOrder(stack, count, result.keys);
+  if (!stack.empty()) {
+    result.cursor = KeyCursor(result.keys.back());
+  }
+  return result;
+}
+
+/**
+ * @brief Continues an in-order walk kept on an explicit stack.
+ *
+ * @param stack The nodes still to visit, the next one on top; each of them is
+ * followed by its right subtree.
+ * @param count The maximum number of keys to collect.
+ * @param keys Receives the keys in ascending order.
+ */
+void SelfBalancingBinarySearchTree::CollectInOrder(
+    std::vector<Index>& stack, std::size_t count,
+    std::vector<Key>& keys) const {
+  while (!stack.empty() and keys.size() < count) {
+    Index node = stack.back();
+    stack.pop_back();
+    keys.push_back(nodes_[node].key);
+    for (node = nodes_[node].right; node != kNull; node = nodes_[node].left) {
+      stack.push_back(node);
+    }
+  }
+}
+
+/**
+ * @brief Returns the number of keys less than the given one.
+ *
+ * @param key The key to look up.
+ *
+ * @return The rank of the key, or std::nullopt if the key is not found.
+ */
+std::optional<std::size_t> SelfBalancingBinarySearchTree::Rank(
+    KeyView key) const {
+  std::size_t rank = 0;
+  for (Index node = root_; node != kNull;) {
+    const AVLNode& current = nodes_[node];
+    if (key < current.key) {
+      node = current.left;
+    } else if (key > current.key) {
+      rank += GetSize(current.left) + 1;
+      node = current.right;
+    } else {
+      return rank + GetSize(current.left);
+    }
+  }
+  return std::nullopt;
+}
+
+/**
+ * @brief Returns the key with the given rank in ascending order.
+ *
+ * @param rank The number of keys less than the wanted one.
+ *
+ * @return The key, or std::nullopt if the tree has no more than rank keys.
+ */
+std::optional<Key> SelfBalancingBinarySearchTree::Select(
+    std::size_t rank) const {
+  for (Index node = root_; node != kNull;) {
+    const AVLNode& current = nodes_[node];
+    std::size_t left_size = GetSize(current.left);
+    if (rank == left_size) return current.key;
+    if (rank < left_size) {
+      node = current.left;
+    } else {
+      rank -= left_size + 1;
+      node = current.right;
+    }
+  }
+  return std::nullopt;
+}
+
+/**
+ * @brief Returns up to count keys in ascending order, starting at the given
+ * rank.
+ *
+ * The walk descends once to the key at the offset and then continues in
+ * order, so a call costs O(log n + count).
+ *
+ * @param offset The rank of the first key to return.
+ * @param count The maximum number of keys to return.
+ * @return The keys, empty if the offset is past the last key.
+ */
+std::vector<Key> SelfBalancingBinarySearchTree::Range(std::size_t offset,
+                                                      std::size_t count) const {
+  std::vector<Index> stack;
+  for (Index node = root_; node != kNull;) {
+    std::size_t left_size = GetSize(nodes_[node].left);
+    if (offset < left_size) {
+      stack.push_back(node);
+      node = nodes_[node].left;
+    } else if (offset == left_size) {
+      stack.push_back(node);
+      break;
+    } else {
+      offset -= left_size + 1;
+      node = nodes_[node].right;
+    }
+  }
+
+  std::vector<Key> keys;
+  CollectInOrder(stack, count, keys);
+  return keys;
+}
+
+/**
+ * @brief Visits the keys from lo to hi inclusive, in ascending order.
+ *
+ * @param lo The smallest key to visit.
+ * @param hi The largest key to visit.
+ * @param visit Called with each key and its value; returning false stops the
+ * walk.
+ */
+void SelfBalancingBinarySearchTree::ForEachInRange(
+    KeyView lo, KeyView hi, const RangeVisitor& visit) const {
+  if (lo > hi) return;
+  WalkFrom(lo, [hi, &visit](const Key& key, const Value& value) {
+    return key <= hi and visit(key, value);
+  });
+}
+
+/**
+ * @brief Visits the keys that start with the prefix, in ascending order.
+ *
+ * Such keys form a contiguous run that begins at the prefix itself, so the
+ * walk starts there and stops at the first key without the prefix.
+ *
+ * @param prefix The prefix of the keys to visit.
+ * @param visit Called with each key and its value; returning false stops the
+ * walk.
+ */
+void SelfBalancingBinarySearchTree::ForEachWithPrefix(
+    KeyView prefix, const RangeVisitor& visit) const {
+  WalkFrom(prefix, [prefix, &visit](const Key& key, const Value& value) {
+    return HasPrefix(key, prefix) and visit(key, value);
+  });
+}
+
+/**
+ * @brief Walks the keys not less than lo in ascending order.
+ *
+ * Subtrees entirely below lo are skipped on the way down and the walk ends as
+ * soon as the visitor returns false, so only the visited part of the tree is
+ * touched.
+ *
+ * @param lo The smallest key to visit.
+ * @param visit Called with each key and its value; returning false stops the
+ * walk.
+ */
+void SelfBalancingBinarySearchTree::WalkFrom(KeyView lo,
+                                             const RangeVisitor& visit) const {
+  std::vector<Index> stack;
+  for (Index node = root_; node != kNull;) {
+    if (nodes_[node].key < lo) {
+      node = nodes_[node].right;
+    } else {
+      stack.push_back(node);
+      node = nodes_[node].left;
+    }
+  }
+
+  while (!stack.empty()) {
+    Index node = stack.back();
+    stack.pop_back();
+    if (!visit(nodes_[node].key, values_[node])) return;
+    for (node = nodes_[node].right; node != kNull; node = nodes_[node].left) {
+      stack.push_back(node);
+    }
+  }
+}
+
 /**
  * @brief Retrieves all values stored in a self-balancing binary search tree.
  *
@@ -210,9 +476,9 @@ std::vector<Value> SelfBalancingBinarySearchTree::ShowAll() const {
  */
 bool SelfBalancingBinarySearchTree::Update(const Key& key,
                                            const std::string& new_value) {
-  auto node = FindNode(root_, key);
-  if (!node.has_value()) return false;
-  node.value()->value.Update(new_value);
+  Index node = FindNode(key);
+  if (node == kNull) return false;
+  values_[node].Update(new_value);
   return true;
 }
 
@@ -226,16 +492,26 @@ bool SelfBalancingBinarySearchTree::Update(const Key& key,
  */
 bool SelfBalancingBinarySearchTree::Rename(const Key& old_key,
                                            const Key& new_key) {
-  auto node = FindNode(root_, old_key);
-  if (!node.has_value()) return false;
-  Value tmp_val = node.value()->value;
-  Del(old_key);
-  return Set(new_key, tmp_val);
+  Path path;
+  Index node = kNull;
+  std::size_t depth = Descend(old_key, path, node);
+  if (node == kNull) return false;
+  if (old_key == new_key) return true;
+  if (FindNode(new_key) != kNull) return false;
+  Detach(path, depth, node);
+  nodes_[node].key = new_key;
+  Index existing = kNull;
+  depth = Descend(new_key, path, existing);
+  Attach(path, depth, node);
+  return true;
 }
 
 /**
  * @brief Uploads data from a file into a self-balancing binary search tree.
  *
+ * An empty tree is built in one pass from the whole file, see Build. A tree
+ * that already holds keys gets the records one by one through Set.
+ *
  * @param file_name The name of the file to upload.
  *
  * @return The number of keys uploaded from the file.
@@ -248,13 +524,21 @@ std::size_t SelfBalancingBinarySearchTree::Upload(
   if (!file.is_open()) throw std::invalid_argument("File can't be opened");
   Key read_key;
   std::string read_value;
-  std::size_t count_keys = 0;
+  std::vector<std::pair<Key, Value>> records;
   while (file >> read_key) {
     std::getline(file >> std::ws, read_value);
-    Set(read_key, Value::FromString(read_value));
-    ++count_keys;
+    records.emplace_back(read_key, Value::FromString(read_value));
   }
   file.close();
+
+  std::size_t count_keys = records.size();
+  if (root_ == kNull) {
+    Build(records);
+  } else {
+    for (auto& [key, value] : records) {
+      Set(key, value);
+    }
+  }
   return count_keys;
 }
 
@@ -294,10 +578,10 @@ std::size_t SelfBalancingBinarySearchTree::Export(
  *         the key is not found
  */
 std::optional<std::size_t> SelfBalancingBinarySearchTree::TTL(
-    const Key& key) const {
-  auto node = FindNode(root_, key);
-  if (!node.has_value()) return std::nullopt;
-  return node.value()->value.TTL();
+    KeyView key) const {
+  Index node = FindNode(key);
+  if (node == kNull) return std::nullopt;
+  return values_[node].TTL();
 }
 
 /**
@@ -324,88 +608,644 @@ std::vector<Key> SelfBalancingBinarySearchTree::Find(
 /**
  * @brief Returns the height of the given AVLNode.
  *
- * @param node a unique pointer to an AVLNode
+ * @param node the index of an AVLNode
+ *
+ * @return the height of the AVLNode, or -1 if the node is kNull
+ */
+int SelfBalancingBinarySearchTree::GetHeight(Index node) const {
+  return (node == kNull) ? -1 : nodes_[node].height;
+}
+
+/**
+ * @brief Returns the number of nodes in the subtree rooted at the given node.
+ *
+ * @param node the index of an AVLNode
+ *
+ * @return the size of the subtree, or 0 if the node is kNull
+ */
+SelfBalancingBinarySearchTree::Index SelfBalancingBinarySearchTree::GetSize(
+    Index node) const {
+  return (node == kNull) ? 0 : nodes_[node].size;
+}
+
+/**
+ * @brief Updates the height and the subtree size of a node in a self-balancing
+ * binary search tree.
  *
- * @return the height of the AVLNode, or -1 if the node is null
+ * @param node the index of the node to update
  */
-int SelfBalancingBinarySearchTree::GetHeight(
-    const std::unique_ptr<AVLNode>& node) const {
-  return (node == nullptr) ? -1 : node->height;
+void SelfBalancingBinarySearchTree::UpdateNode(Index node) {
+  AVLNode& current = nodes_[node];
+  current.height = static_cast<std::int8_t>(
+      std::max(GetHeight(current.left), GetHeight(current.right)) + 1);
+  UpdateSize(node);
 }
 
 /**
- * @brief Updates the height of a node in a self-balancing binary search tree.
+ * @brief Updates the subtree size of a node from the sizes of its children.
  *
- * @param node a reference to the node to update the height of
+ * @param node the index of the node to update
  */
-void SelfBalancingBinarySearchTree::UpdateHeight(
-    std::unique_ptr<AVLNode>& node) {
-  node->height = std::max(GetHeight(node->left), GetHeight(node->right)) + 1;
+void SelfBalancingBinarySearchTree::UpdateSize(Index node) {
+  AVLNode& current = nodes_[node];
+  current.size = GetSize(current.left) + GetSize(current.right) + 1;
 }
 
 /**
  * @brief Calculates the balance factor of a given node in a self-balancing
  * binary search tree.
  *
- * @param node A pointer to the node for which the balance factor is being
+ * @param node The index of the node for which the balance factor is being
  * calculated.
  *
  * @return The balance factor of the node, which is the difference between the
  * height of its right subtree and the height of its left subtree.
  */
-int SelfBalancingBinarySearchTree::GetBalance(
-    const std::unique_ptr<AVLNode>& node) const {
-  return (node == nullptr) ? 0 : GetHeight(node->right) - GetHeight(node->left);
+int SelfBalancingBinarySearchTree::GetBalance(Index node) const {
+  return (node == kNull)
+             ? 0
+             : GetHeight(nodes_[node].right) - GetHeight(nodes_[node].left);
 }
 
 /**
  * @brief RotateLeft function rotates the given node to the left in a
  * self-balancing binary search tree.
  *
- * @param node the node to be rotated
+ * @param node the index of the node to be rotated
+ *
+ * @return the index of the node that took its place
  */
-void SelfBalancingBinarySearchTree::RotateLeft(std::unique_ptr<AVLNode>& node) {
-  std::unique_ptr<AVLNode> buffer = std::move(node->right);
-  node->right = std::move(buffer->left);
-  buffer->left = std::move(node);
-  node = std::move(buffer);
-  UpdateHeight(node->left);
-  UpdateHeight(node);
+SelfBalancingBinarySearchTree::Index SelfBalancingBinarySearchTree::RotateLeft(
+    Index node) {
+  Index buffer = nodes_[node].right;
+  nodes_[node].right = nodes_[buffer].left;
+  nodes_[buffer].left = node;
+  UpdateNode(node);
+  UpdateNode(buffer);
+  return buffer;
 }
 
 /**
  * @brief Rotates a node to the right in a Self-Balancing Binary Search Tree.
  *
- * @param node The node to be rotated.
+ * @param node The index of the node to be rotated.
+ *
+ * @return The index of the node that took its place.
  */
-void SelfBalancingBinarySearchTree::RotateRight(
-    std::unique_ptr<AVLNode>& node) {
-  std::unique_ptr<AVLNode> buffer = std::move(node->left);
-  node->left = std::move(buffer->right);
-  buffer->right = std::move(node);
-  node = std::move(buffer);
-  UpdateHeight(node->right);
-  UpdateHeight(node);
+SelfBalancingBinarySearchTree::Index
+SelfBalancingBinarySearchTree::RotateRight(Index node) {
+  Index buffer = nodes_[node].left;
+  nodes_[node].left = nodes_[buffer].right;
+  nodes_[buffer].right = node;
+  UpdateNode(node);
+  UpdateNode(buffer);
+  return buffer;
 }
 
 /**
  * @brief Balances a node in a self-balancing binary search tree.
  *
- * @param node A reference to a unique_ptr to the AVLNode to be balanced.
+ * @param node The index of the AVLNode to be balanced.
+ *
+ * @return The index of the root node of the balanced subtree.
  */
-void SelfBalancingBinarySearchTree::BalanceNode(
-    std::unique_ptr<AVLNode>& node) {
+SelfBalancingBinarySearchTree::Index
+SelfBalancingBinarySearchTree::BalanceNode(Index node) {
   if (GetBalance(node) == -2) {
-    if (GetBalance(node->left) > 0) {
-      RotateLeft(node->left);
+    if (GetBalance(nodes_[node].left) > 0) {
+      nodes_[node].left = RotateLeft(nodes_[node].left);
     }
-    RotateRight(node);
-  } else if (GetBalance(node) == 2) {
-    if (GetBalance(node->right) < 0) {
-      RotateRight(node->right);
+    return RotateRight(node);
+  }
+  if (GetBalance(node) == 2) {
+    if (GetBalance(nodes_[node].right) < 0) {
+      nodes_[node].right = RotateRight(nodes_[node].right);
     }
-    RotateLeft(node);
+    return RotateLeft(node);
+  }
+  return node;
+}
+
+/**
+ * @brief Places a new node in the arena, reusing a freed slot if there is one.
+ *
+ * @param key The key of the new node.
+ * @param value The value of the new node.
+ *
+ * @return The index of the new node.
+ */
+SelfBalancingBinarySearchTree::Index SelfBalancingBinarySearchTree::NewNode(
+    const Key& key, const Value& value) {
+  if (free_ != kNull) {
+    Index node = free_;
+    free_ = nodes_[node].left;
+    nodes_[node] = AVLNode(key);
+    values_[node] = value;
+    return node;
+  }
+  if (nodes_.size() >= kNull) {
+    throw std::length_error("Too many nodes in the tree");
+  }
+  nodes_.emplace_back(key);
+  values_.push_back(value);
+  return static_cast<Index>(nodes_.size() - 1);
+}
+
+/**
+ * @brief Releases the key and value of a node and puts its slot on the free
+ * list, which is chained through the left links.
+ *
+ * @param node The index of a node that is no longer linked into the tree.
+ */
+void SelfBalancingBinarySearchTree::FreeNode(Index node) {
+  nodes_[node] = AVLNode(Key());
+  values_[node] = Value();
+  nodes_[node].left = free_;
+  free_ = node;
+}
+
+/**
+ * @brief Replaces the contents of the tree with a perfectly balanced tree of
+ * the given records.
+ *
+ * The records are sorted unless they already are, as files written by Export
+ * are. Of several records with the same key the first one is kept, as with
+ * Set. The nodes are laid out in key order and linked bottom-up in O(n).
+ *
+ * @param records The records to load; their keys and values are moved out.
+ *
+ * @throws std::length_error If there are too many records for the arena.
+ */
+void SelfBalancingBinarySearchTree::Build(
+    std::vector<std::pair<Key, Value>>& records) {
+  SortRecords(records);
+  if (records.size() >= kNull) {
+    throw std::length_error("Too many nodes in the tree");
+  }
+
+  nodes_.clear();
+  values_.clear();
+  nodes_.reserve(records.size());
+  values_.reserve(records.size());
+  for (auto& [key, value] : records) {
+    nodes_.emplace_back(std::move(key));
+    values_.push_back(std::move(value));
+  }
+  free_ = kNull;
+  root_ = BuildSubtree(0, static_cast<Index>(nodes_.size()));
+}
+
+/**
+ * @brief Links the nodes in [first, last) into a balanced subtree.
+ *
+ * @param first The index of the smallest node of the subtree.
+ * @param last The index past the largest node of the subtree.
+ *
+ * @return The index of the root of the subtree, or kNull if it is empty.
+ */
+SelfBalancingBinarySearchTree::Index
+SelfBalancingBinarySearchTree::BuildSubtree(Index first, Index last) {
+  if (first == last) return kNull;
+  Index middle = first + (last - first) / 2;
+  nodes_[middle].left = BuildSubtree(first, middle);
+  nodes_[middle].right = BuildSubtree(middle + 1, last);
+  UpdateNode(middle);
+  return middle;
+}
+
+/**
+ * @brief Sorts keys unless they already are, and drops the duplicates.
+ *
+ * @param keys The keys to sort.
+ */
+void SelfBalancingBinarySearchTree::SortKeys(std::vector<Key>& keys) {
+  if (!std::is_sorted(keys.begin(), keys.end())) {
+    std::sort(keys.begin(), keys.end());
+  }
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+}
+
+/**
+ * @brief Returns all records of the tree in key order.
+ */
+std::vector<std::pair<Key, Value>> SelfBalancingBinarySearchTree::Records()
+    const {
+  std::vector<Key> keys;
+  std::vector<Value> values;
+  InOrderTraversal(root_, keys, values);
+  std::vector<std::pair<Key, Value>> records;
+  records.reserve(keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    records.emplace_back(std::move(keys[i]), std::move(values[i]));
+  }
+  return records;
+}
+
+/**
+ * @brief Adds the records of another tree whose keys are not in this one.
+ *
+ * @param other The tree to merge in; it is not modified.
+ *
+ * @return The number of keys added.
+ */
+std::size_t SelfBalancingBinarySearchTree::Union(
+    const SelfBalancingBinarySearchTree& other) {
+  return Union(other.Records());
+}
+
+/**
+ * @brief Adds the records whose keys are not in the tree yet.
+ *
+ * Keys already in the tree keep their values, as with Set. The records are
+ * built into a balanced tree in the same arena, and the two trees are merged
+ * by splitting the batch at the root of the tree and joining the merged
+ * halves back. The halves are merged in parallel while they are large enough.
+ *
+ * @param records The records to add, in any order.
+ *
+ * @return The number of keys added.
+ *
+ * @throws std::length_error If there are too many nodes for the arena.
+ */
+std::size_t SelfBalancingBinarySearchTree::Union(
+    std::vector<std::pair<Key, Value>> records) {
+  SortRecords(records);
+  if (records.empty()) return 0;
+  if (records.size() >= kNull - nodes_.size()) {
+    throw std::length_error("Too many nodes in the tree");
   }
+
+  std::size_t old_size = GetSize(root_);
+  Index first = static_cast<Index>(nodes_.size());
+  nodes_.reserve(nodes_.size() + records.size());
+  values_.reserve(values_.size() + records.size());
+  for (auto& [key, value] : records) {
+    nodes_.emplace_back(std::move(key));
+    values_.push_back(std::move(value));
+  }
+  Index batch = BuildSubtree(first, static_cast<Index>(nodes_.size()));
+
+  std::vector<Index> dropped;
+  root_ = UnionHelper(root_, batch, SpawnDepth(), dropped);
+  for (Index node : dropped) {
+    FreeNode(node);
+  }
+  return GetSize(root_) - old_size;
+}
+
+/**
+ * @brief Removes the keys that are present in another tree.
+ *
+ * @param other The tree whose keys are removed; it is not modified.
+ *
+ * @return The number of keys removed.
+ */
+std::size_t SelfBalancingBinarySearchTree::Difference(
+    const SelfBalancingBinarySearchTree& other) {
+  return Difference(other.Keys());
+}
+
+/**
+ * @brief Removes the given keys from the tree.
+ *
+ * The sorted batch is treated as a balanced tree rooted at its middle key: the
+ * tree is split at that key and the two halves of the batch are subtracted
+ * from the two sides, in parallel while they are large enough, before the
+ * sides are joined back.
+ *
+ * @param keys The keys to remove, in any order.
+ *
+ * @return The number of keys removed.
+ */
+std::size_t SelfBalancingBinarySearchTree::Difference(std::vector<Key> keys) {
+  SortKeys(keys);
+  std::vector<Index> dropped;
+  root_ = DifferenceHelper(root_, keys.data(), keys.data() + keys.size(),
+                           SpawnDepth(), dropped);
+  for (Index node : dropped) {
+    FreeNode(node);
+  }
+  return dropped.size();
+}
+
+/**
+ * @brief Keeps only the keys that are also present in another tree.
+ *
+ * @param other The tree whose keys are kept; it is not modified.
+ *
+ * @return The number of keys removed.
+ */
+std::size_t SelfBalancingBinarySearchTree::Intersection(
+    const SelfBalancingBinarySearchTree& other) {
+  return Intersection(other.Keys());
+}
+
+/**
+ * @brief Keeps only the given keys in the tree.
+ *
+ * Works like Difference, except that the key found at each split is kept and
+ * the parts of the tree outside the batch are dropped.
+ *
+ * @param keys The keys to keep, in any order.
+ *
+ * @return The number of keys removed.
+ */
+std::size_t SelfBalancingBinarySearchTree::Intersection(std::vector<Key> keys) {
+  SortKeys(keys);
+  std::vector<Index> dropped;
+  root_ = IntersectionHelper(root_, keys.data(), keys.data() + keys.size(),
+                             SpawnDepth(), dropped);
+  for (Index node : dropped) {
+    FreeNode(node);
+  }
+  return dropped.size();
+}
+
+/**
+ * @brief Merges two trees of the same arena.
+ *
+ * @param node The root of the tree whose records win on equal keys.
+ * @param other The root of the tree to merge in.
+ * @param spawn How many more levels may fork onto another thread.
+ * @param dropped Receives the nodes of other whose keys are already present.
+ *
+ * @return The root of the merged tree.
+ */
+SelfBalancingBinarySearchTree::Index
+SelfBalancingBinarySearchTree::UnionHelper(Index node, Index other, int spawn,
+                                           std::vector<Index>& dropped) {
+  if (node == kNull) return other;
+  if (other == kNull) return node;
+  bool parallel =
+      spawn > 0 and GetSize(node) + GetSize(other) >= kParallelGrain;
+
+  Index other_left, duplicate, other_right;
+  Split(other, nodes_[node].key, other_left, duplicate, other_right);
+  if (duplicate != kNull) dropped.push_back(duplicate);
+
+  Index left = nodes_[node].left;
+  Index right = nodes_[node].right;
+  std::vector<Index> right_dropped;
+  Fork(
+      parallel,
+      [&] { left = UnionHelper(left, other_left, spawn - 1, dropped); },
+      [&] {
+        right = UnionHelper(right, other_right, spawn - 1, right_dropped);
+      });
+  dropped.insert(dropped.end(), right_dropped.begin(), right_dropped.end());
+  return Join(left, node, right);
+}
+
+/**
+ * @brief Removes the keys in [first, last) from a subtree.
+ *
+ * @param node The root of the subtree.
+ * @param first The smallest key to remove.
+ * @param last Past the largest key to remove.
+ * @param spawn How many more levels may fork onto another thread.
+ * @param dropped Receives the removed nodes.
+ *
+ * @return The root of the remaining subtree.
+ */
+SelfBalancingBinarySearchTree::Index
+SelfBalancingBinarySearchTree::DifferenceHelper(Index node, const Key* first,
+                                                const Key* last, int spawn,
+                                                std::vector<Index>& dropped) {
+  if (node == kNull or first == last) return node;
+  std::size_t work = GetSize(node) + static_cast<std::size_t>(last - first);
+  bool parallel = spawn > 0 and work >= kParallelGrain;
+
+  const Key* middle = first + (last - first) / 2;
+  Index left, found, right;
+  Split(node, *middle, left, found, right);
+  if (found != kNull) dropped.push_back(found);
+
+  std::vector<Index> right_dropped;
+  Fork(
+      parallel,
+      [&] { left = DifferenceHelper(left, first, middle, spawn - 1, dropped); },
+      [&] {
+        right = DifferenceHelper(right, middle + 1, last, spawn - 1,
+                                 right_dropped);
+      });
+  dropped.insert(dropped.end(), right_dropped.begin(), right_dropped.end());
+  return Join2(left, right);
+}
+
+/**
+ * @brief Removes the keys not in [first, last) from a subtree.
+ *
+ * @param node The root of the subtree.
+ * @param first The smallest key to keep.
+ * @param last Past the largest key to keep.
+ * @param spawn How many more levels may fork onto another thread.
+ * @param dropped Receives the removed nodes.
+ *
+ * @return The root of the remaining subtree.
+ */
+SelfBalancingBinarySearchTree::Index
+SelfBalancingBinarySearchTree::IntersectionHelper(Index node, const Key* first,
+                                                  const Key* last, int spawn,
+                                                  std::vector<Index>& dropped) {
+  if (node == kNull) return kNull;
+  if (first == last) {
+    CollectSubtree(node, dropped);
+    return kNull;
+  }
+  std::size_t work = GetSize(node) + static_cast<std::size_t>(last - first);
+  bool parallel = spawn > 0 and work >= kParallelGrain;
+
+  const Key* middle = first + (last - first) / 2;
+  Index left, found, right;
+  Split(node, *middle, left, found, right);
+
+  std::vector<Index> right_dropped;
+  Fork(
+      parallel,
+      [&] {
+        left = IntersectionHelper(left, first, middle, spawn - 1, dropped);
+      },
+      [&] {
+        right = IntersectionHelper(right, middle + 1, last, spawn - 1,
+                                   right_dropped);
+      });
+  dropped.insert(dropped.end(), right_dropped.begin(), right_dropped.end());
+  return (found == kNull) ? Join2(left, right) : Join(left, found, right);
+}
+
+/**
+ * @brief Splits a subtree into the keys less than and greater than a key.
+ *
+ * @param node The root of the subtree.
+ * @param key The key to split at.
+ * @param left Receives the root of the keys less than key.
+ * @param found Receives the node with the key, or kNull.
+ * @param right Receives the root of the keys greater than key.
+ */
+void SelfBalancingBinarySearchTree::Split(Index node, KeyView key, Index& left,
+                                          Index& found, Index& right) {
+  if (node == kNull) {
+    left = found = right = kNull;
+    return;
+  }
+  Index node_left = nodes_[node].left;
+  Index node_right = nodes_[node].right;
+  if (key < nodes_[node].key) {
+    Index middle;
+    Split(node_left, key, left, found, middle);
+    right = Join(middle, node, node_right);
+  } else if (key > nodes_[node].key) {
+    Index middle;
+    Split(node_right, key, middle, found, right);
+    left = Join(node_left, node, middle);
+  } else {
+    left = node_left;
+    found = node;
+    right = node_right;
+  }
+}
+
+/**
+ * @brief Joins two subtrees and a node whose key lies between them.
+ *
+ * The node is hung along the spine of the taller subtree at the height of the
+ * shorter one, so the cost is proportional to the difference of the heights.
+ *
+ * @param left The root of the subtree with the smaller keys.
+ * @param node The index of the middle node; its links are overwritten.
+ * @param right The root of the subtree with the larger keys.
+ *
+ * @return The root of the joined tree.
+ */
+SelfBalancingBinarySearchTree::Index SelfBalancingBinarySearchTree::Join(
+    Index left, Index node, Index right) {
+  if (GetHeight(left) > GetHeight(right) + 1) {
+    return JoinRight(left, node, right);
+  }
+  if (GetHeight(right) > GetHeight(left) + 1) {
+    return JoinLeft(left, node, right);
+  }
+  nodes_[node].left = left;
+  nodes_[node].right = right;
+  UpdateNode(node);
+  return node;
+}
+
+/**
+ * @brief Joins when the left subtree is the taller one.
+ */
+SelfBalancingBinarySearchTree::Index SelfBalancingBinarySearchTree::JoinRight(
+    Index left, Index node, Index right) {
+  Index spine = nodes_[left].right;
+  if (GetHeight(spine) <= GetHeight(right) + 1) {
+    nodes_[node].left = spine;
+    nodes_[node].right = right;
+    UpdateNode(node);
+    nodes_[left].right = node;
+  } else {
+    Index joined = JoinRight(spine, node, right);
+    nodes_[left].right = joined;
+  }
+  UpdateNode(left);
+  return BalanceNode(left);
+}
+
+/**
+ * @brief Joins when the right subtree is the taller one.
+ */
+SelfBalancingBinarySearchTree::Index SelfBalancingBinarySearchTree::JoinLeft(
+    Index left, Index node, Index right) {
+  Index spine = nodes_[right].left;
+  if (GetHeight(spine) <= GetHeight(left) + 1) {
+    nodes_[node].left = left;
+    nodes_[node].right = spine;
+    UpdateNode(node);
+    nodes_[right].left = node;
+  } else {
+    Index joined = JoinLeft(left, node, spine);
+    nodes_[right].left = joined;
+  }
+  UpdateNode(right);
+  return BalanceNode(right);
+}
+
+/**
+ * @brief Joins two subtrees where every key of the left one is smaller, using
+ * the largest node of the left subtree as the middle node.
+ */
+SelfBalancingBinarySearchTree::Index SelfBalancingBinarySearchTree::Join2(
+    Index left, Index right) {
+  if (left == kNull) return right;
+  if (right == kNull) return left;
+  Index last;
+  Index rest = SplitLast(left, last);
+  return Join(rest, last, right);
+}
+
+/**
+ * @brief Unlinks the node with the largest key from a subtree.
+ *
+ * @param node The root of the subtree.
+ * @param last Receives the index of the unlinked node.
+ *
+ * @return The root of the rest of the subtree.
+ */
+SelfBalancingBinarySearchTree::Index SelfBalancingBinarySearchTree::SplitLast(
+    Index node, Index& last) {
+  if (nodes_[node].right == kNull) {
+    last = node;
+    return nodes_[node].left;
+  }
+  Index rest = SplitLast(nodes_[node].right, last);
+  return Join(nodes_[node].left, node, rest);
+}
+
+/**
+ * @brief Appends the indices of all nodes of a subtree.
+ *
+ * @param node The root of the subtree.
+ * @param nodes Receives the indices.
+ */
+void SelfBalancingBinarySearchTree::CollectSubtree(
+    Index node, std::vector<Index>& nodes) const {
+  if (node == kNull) return;
+  std::vector<Index> stack{node};
+  while (!stack.empty()) {
+    node = stack.back();
+    stack.pop_back();
+    nodes.push_back(node);
+    if (nodes_[node].left != kNull) stack.push_back(nodes_[node].left);
+    if (nodes_[node].right != kNull) stack.push_back(nodes_[node].right);
+  }
+}
+
+/**
+ * @brief Returns how many levels of a set operation may fork, so that about
+ * one task per hardware thread is created.
+ */
+int SelfBalancingBinarySearchTree::SpawnDepth() {
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  int depth = 0;
+  while ((1u << depth) < threads) ++depth;
+  return depth;
+}
+
+/**
+ * @brief Runs two tasks, the first one on another thread if parallel is set.
+ *
+ * The tasks must touch disjoint nodes and must not allocate from the arena.
+ */
+void SelfBalancingBinarySearchTree::Fork(bool parallel,
+                                         const std::function<void()>& first,
+                                         const std::function<void()>& second) {
+  if (!parallel) {
+    first();
+    second();
+    return;
+  }
+  std::future<void> task = std::async(std::launch::async, first);
+  second();
+  task.get();
 }
 
 /**
@@ -423,21 +1263,23 @@ void SelfBalancingBinarySearchTree::MakeDotFile(
   if (!file.is_open()) throw std::invalid_argument("File can't be opened");
   file << "digraph BST {\n";
   file << "    node [shape=circle, style=filled, fillcolor=green];\n";
-  std::function<void(const std::unique_ptr<AVLNode>& node)> writeNodes =
-      [&](const std::unique_ptr<AVLNode>& node) {
-        if (node == nullptr) {
-          return;
-        }
-        file << "    " << node->key << ";\n";
-        if (node->left != nullptr) {
-          file << "    " << node->key << " -> " << node->left->key << ";\n";
-          writeNodes(node->left);
-        }
-        if (node->right != nullptr) {
-          file << "    " << node->key << " -> " << node->right->key << ";\n";
-          writeNodes(node->right);
-        }
-      };
+  std::function<void(Index node)> writeNodes = [&](Index node) {
+    if (node == kNull) {
+      return;
+    }
+    const AVLNode& current = nodes_[node];
+    file << "    " << current.key << ";\n";
+    if (current.left != kNull) {
+      file << "    " << current.key << " -> " << nodes_[current.left].key
+           << ";\n";
+      writeNodes(current.left);
+    }
+    if (current.right != kNull) {
+      file << "    " << current.key << " -> " << nodes_[current.right].key
+           << ";\n";
+      writeNodes(current.right);
+    }
+  };
   writeNodes(root_);
   file << "}";
   file.close();
@@ -452,21 +1294,7 @@ void SelfBalancingBinarySearchTree::MakeDotFile(
  * @return the balance factor of the node
  */
 int SelfBalancingBinarySearchTree::GetBalance(const Key& key) const {
-  auto node = FindNode(root_, key);
-  return (node.value() == nullptr)
-             ? 0
-             : GetHeight(node.value()->right) - GetHeight(node.value()->left);
-}
-
-/**
- * @brief Returns the height of the given AVLNode.
- *
- * @param node a pointer to the AVLNode
- *
- * @return the height of the AVLNode; -1 if the node is nullptr
- */
-int SelfBalancingBinarySearchTree::GetHeight(const AVLNode* node) const {
-  return (node == nullptr) ? -1 : node->height;
+  return GetBalance(FindNode(key));
 }
 
 /**
@@ -476,8 +1304,8 @@ int SelfBalancingBinarySearchTree::GetHeight(const AVLNode* node) const {
  * @return The key of the root node, or an empty string if the tree is empty.
  */
 const Key SelfBalancingBinarySearchTree::GetRootKey() const {
-  if (root_ == nullptr) return "";
-  return root_->key;
+  if (root_ == kNull) return "";
+  return nodes_[root_].key;
 }
 
 /**
@@ -489,7 +1317,7 @@ void SelfBalancingBinarySearchTree::DeleteExpiredElements() {
   InOrderTraversal(root_, vec_keys, vec_values);
   for (auto i = 0u; i < vec_keys.size(); ++i) {
     if (vec_values[i].TTL() == 0u) {
-      root_ = DeletHelper(std::move(root_), vec_keys[i]);
+      Del(vec_keys[i]);
     }
   }
 }
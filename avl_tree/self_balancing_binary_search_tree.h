@@ -1,10 +1,16 @@
 #ifndef __SELF_BALANCING_BINARY_SEARCH_TREE_H__
 #define __SELF_BALANCING_BINARY_SEARCH_TREE_H__
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <fstream>
 #include <functional>
-#include <memory>
+#include <future>
+#include <limits>
+#include <thread>
+#include <utility>
 
 #include "../common/abstract_store.h"
 
@@ -13,9 +19,9 @@ namespace s21 {
 class SelfBalancingBinarySearchTree : public AbstractStore {
  public:
   bool Set(const Key& key, const Value& value) override;
-  bool Exists(const Key& key) const override;
-  bool Del(const Key& key) override;
-  std::optional<Value> Get(const Key& key) const override;
+  bool Exists(KeyView key) const override;
+  bool Del(KeyView key) override;
+  std::optional<Value> Get(KeyView key) const override;
   std::vector<Key> Keys() const override;
   std::vector<Value> ShowAll() const override;
   bool Update(const Key& key, const std::string& new_value) override;
@@ -23,42 +29,105 @@ class SelfBalancingBinarySearchTree : public AbstractStore {
   std::size_t Upload(const std::string& file_name) override;
   std::size_t Export(const std::string& file_name) const override;
   std::vector<Key> Find(const std::string& value) const override;
-  std::optional<std::size_t> TTL(const Key& key) const override;
+  std::optional<std::size_t> TTL(KeyView key) const override;
+  std::size_t Union(const SelfBalancingBinarySearchTree& other);
+  std::size_t Union(std::vector<std::pair<Key, Value>> records);
+  std::size_t Difference(const SelfBalancingBinarySearchTree& other);
+  std::size_t Difference(std::vector<Key> keys);
+  std::size_t Intersection(const SelfBalancingBinarySearchTree& other);
+  std::size_t Intersection(std::vector<Key> keys);
   void MakeDotFile(const std::string& file_name) const;
   int GetBalance(const Key& key) const;
   const Key GetRootKey() const;
   void DeleteExpiredElements() override;
+  ScanResult Scan(const std::string& cursor, std::size_t count) const override;
+  bool HasBoundedScan() const override { return true; }
+  std::optional<std::size_t> Rank(KeyView key) const override;
+  std::optional<Key> Select(std::size_t rank) const override;
+  std::vector<Key> Range(std::size_t offset, std::size_t count) const override;
+  void ForEachInRange(KeyView lo, KeyView hi,
+                      const RangeVisitor& visit) const override;
+  void ForEachWithPrefix(KeyView prefix,
+                         const RangeVisitor& visit) const override;
 
  private:
+  using Index = std::uint32_t;
+
+  static constexpr Index kNull = std::numeric_limits<Index>::max();
+  /// An AVL tree of 2^32 nodes is less than 48 levels deep.
+  static constexpr std::size_t kMaxDepth = 64;
+
+  /// The ancestors of a node, from the root down.
+  using Path = std::array<Index, kMaxDepth>;
+  /// Set operations smaller than this run on the calling thread only.
+  static constexpr std::size_t kParallelGrain = 4096;
+
+  /**
+   * @brief Hot part of a tree node: the key and the links to the children.
+   *
+   * Nodes live in one arena and refer to each other by 32-bit indices. The
+   * height fits in a byte that would otherwise be padding. The size of the
+   * subtree is kept for rank and select queries. The value of a node is kept
+   * out of line in values_ under the same index, so a search touches only keys
+   * and links.
+   */
   struct AVLNode {
-    AVLNode(const Key& k, const Value& v)
-        : key(k), value(v), left(nullptr), right(nullptr), height(0){};
+    explicit AVLNode(Key k)
+        : key(std::move(k)), left(kNull), right(kNull), size(1), height(0) {}
     Key key;
-    Value value;
-    std::unique_ptr<AVLNode> left;
-    std::unique_ptr<AVLNode> right;
-    int height;
+    Index left;
+    Index right;
+    Index size;
+    std::int8_t height;
   };
 
-  int GetBalance(const std::unique_ptr<AVLNode>& node) const;
-  int GetHeight(const std::unique_ptr<AVLNode>& node) const;
-  int GetHeight(const AVLNode* node) const;
-  void InOrderTraversal(const std::unique_ptr<AVLNode>& node,
-                        std::vector<Key>& keys,
+  int GetBalance(Index node) const;
+  int GetHeight(Index node) const;
+  Index GetSize(Index node) const;
+  void InOrderTraversal(Index node, std::vector<Key>& keys,
                         std::vector<Value>& values) const;
-  void InsertHelper(std::unique_ptr<AVLNode>& node, const Key& key,
-                    const Value& value);
-  std::optional<AVLNode*> FindNode(const std::unique_ptr<AVLNode>& node,
-                                   const Key& key) const;
-  std::unique_ptr<AVLNode> DeletHelper(std::unique_ptr<AVLNode> node,
-                                       const Key& key);
-  void UpdateHeight(std::unique_ptr<AVLNode>& node);
-  void RotateLeft(std::unique_ptr<AVLNode>& node);
-  void RotateRight(std::unique_ptr<AVLNode>& node);
-  void BalanceNode(std::unique_ptr<AVLNode>& node);
-  const AVLNode* FindMin(const AVLNode* node) const;
+  Index FindNode(KeyView key) const;
+  std::size_t Descend(KeyView key, Path& path, Index& node) const;
+  void Attach(const Path& path, std::size_t depth, Index node);
+  void Detach(Path& path, std::size_t depth, Index node);
+  void Relink(const Path& path, std::size_t depth, Index old_child,
+              Index new_child);
+  void Rebalance(const Path& path, std::size_t depth);
+  void UpdateNode(Index node);
+  void UpdateSize(Index node);
+  void WalkFrom(KeyView lo, const RangeVisitor& visit) const;
+  void CollectInOrder(std::vector<Index>& stack, std::size_t count,
+                      std::vector<Key>& keys) const;
+  Index RotateLeft(Index node);
+  Index RotateRight(Index node);
+  Index BalanceNode(Index node);
+  Index NewNode(const Key& key, const Value& value);
+  void FreeNode(Index node);
+  void Build(std::vector<std::pair<Key, Value>>& records);
+  Index BuildSubtree(Index first, Index last);
+  Index Join(Index left, Index node, Index right);
+  Index JoinLeft(Index left, Index node, Index right);
+  Index JoinRight(Index left, Index node, Index right);
+  Index Join2(Index left, Index right);
+  Index SplitLast(Index node, Index& last);
+  void Split(Index node, KeyView key, Index& left, Index& found, Index& right);
+  Index UnionHelper(Index node, Index other, int spawn,
+                    std::vector<Index>& dropped);
+  Index DifferenceHelper(Index node, const Key* first, const Key* last,
+                         int spawn, std::vector<Index>& dropped);
+  Index IntersectionHelper(Index node, const Key* first, const Key* last,
+                           int spawn, std::vector<Index>& dropped);
+  void CollectSubtree(Index node, std::vector<Index>& nodes) const;
+  std::vector<std::pair<Key, Value>> Records() const;
+  static void SortKeys(std::vector<Key>& keys);
+  static int SpawnDepth();
+  static void Fork(bool parallel, const std::function<void()>& first,
+                   const std::function<void()>& second);
 
-  std::unique_ptr<SelfBalancingBinarySearchTree::AVLNode> root_;
+  std::vector<AVLNode> nodes_;
+  std::vector<Value> values_;
+  Index root_ = kNull;
+  Index free_ = kNull;
 };
 
 }  // namespace s21
@@ -1,7 +1,69 @@
 #include "b_plus_node.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace s21 {
 
+#if defined(__SSE2__)
+namespace {
+
+/**
+ * @brief The number of heads below which SearchHeads stops halving and
+ * compares the remaining heads with SSE2.
+ */
+constexpr std::size_t kHeadWindow = 8;
+
+/**
+ * @brief Compares two pairs of heads as unsigned 64-bit integers.
+ *
+ * SSE2 only compares signed 32-bit lanes, so both halves of every head get
+ * their sign bit flipped first. A head is greater than another when its high
+ * half is, or when the high halves are equal and its low half is greater.
+ *
+ * @return A mask whose high 32-bit lane of each pair is all ones where the
+ * head in a is greater than the one in b.
+ */
+__m128i Greater(__m128i a, __m128i b) {
+  const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+  __m128i gt = _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+  __m128i eq = _mm_cmpeq_epi32(a, b);
+  __m128i gt_low = _mm_shuffle_epi32(gt, _MM_SHUFFLE(2, 2, 0, 0));
+  return _mm_or_si128(gt, _mm_and_si128(eq, gt_low));
+}
+
+/**
+ * @brief Counts the heads less than, or not greater than, the given head, two
+ * at a time.
+ *
+ * @param heads The sorted heads.
+ * @param size The number of heads.
+ * @param head The head to compare with.
+ * @param upper Whether to count the heads not greater than head instead.
+ * @return The number of heads found.
+ */
+std::size_t CountHeads(const std::uint64_t* heads, std::size_t size,
+                       std::uint64_t head, bool upper) {
+  const __m128i key = _mm_set1_epi64x(static_cast<long long>(head));
+  std::size_t greater = 0;
+  std::size_t less = 0;
+  std::size_t i = 0;
+  for (; i + 2 <= size; i += 2) {
+    __m128i pair = _mm_loadu_si128(reinterpret_cast<const __m128i*>(heads + i));
+    int mask = _mm_movemask_pd(
+        _mm_castsi128_pd(upper ? Greater(pair, key) : Greater(key, pair)));
+    (upper ? greater : less) += (mask & 1) + (mask >> 1);
+  }
+  for (; i < size; ++i) {
+    (upper ? greater : less) += upper ? heads[i] > head : heads[i] < head;
+  }
+  return upper ? size - greater : less;
+}
+
+}  // namespace
+#endif
+
 /**
  * @brief Constructs a new BPlusNode object.
  *
@@ -12,7 +74,8 @@ namespace s21 {
  *
  * @param type The type of the node (either kLeaf or kInternal).
  */
-BPlusNode::BPlusNode(const NodeType type) : type_(type), parent_(), next_() {}
+BPlusNode::BPlusNode(const NodeType type)
+    : type_(type), head_offset_(0), parent_(nullptr), next_(nullptr) {}
 
 /**
  * @brief Checks if the node is a leaf node.
@@ -40,8 +103,243 @@ std::size_t BPlusNode::Size() const { return keys_.size(); }
  * @param key The key to search for.
  * @return true if the key exists in the node, false otherwise.
  */
-bool BPlusNode::Exists(const Key& key) const {
-  return std::binary_search(keys_.begin(), keys_.end(), key);
+bool BPlusNode::Exists(KeyView key) const {
+  if (key.compare(0, prefix_.size(), prefix_) != 0) return false;
+  key.remove_prefix(prefix_.size());
+  std::size_t idx = Search(key, false);
+  return idx < keys_.size() and KeyView(keys_[idx]) == key;
+}
+
+/**
+ * @brief Returns the index of the first key not less than the given key.
+ *
+ * A key without the node's prefix sorts before or after every key of the
+ * node, so only a key with the prefix is searched for, by its suffix.
+ *
+ * @param key The key to search for.
+ * @return The index of the first key not less than key, or Size().
+ */
+std::size_t BPlusNode::LowerBound(KeyView key) const {
+  int order = key.compare(0, prefix_.size(), prefix_);
+  if (order != 0) return order < 0 ? 0 : keys_.size();
+  key.remove_prefix(prefix_.size());
+  return Search(key, false);
+}
+
+/**
+ * @brief Returns the index of the first key greater than the given key.
+ *
+ * @param key The key to search for.
+ * @return The index of the first key greater than key, or Size().
+ */
+std::size_t BPlusNode::UpperBound(KeyView key) const {
+  int order = key.compare(0, prefix_.size(), prefix_);
+  if (order != 0) return order < 0 ? 0 : keys_.size();
+  key.remove_prefix(prefix_.size());
+  return Search(key, true);
+}
+
+/**
+ * @brief Moves the longest prefix shared by all keys of the node into the
+ * node's prefix.
+ *
+ * The keys are sorted, so the prefix shared by the first and the last one is
+ * shared by all of them.
+ */
+void BPlusNode::CompressKeys() {
+  if (keys_.empty()) return;
+  std::size_t size = CommonPrefix(keys_.front(), keys_.back());
+  if (size == 0) return;
+  prefix_ += keys_.front().substr(0, size);
+  for (Key& key : keys_) key.erase(0, size);
+  RebuildHeads();
+}
+
+/**
+ * @brief Shortens the node's prefix, moving the cut part back into every key.
+ *
+ * @param size The new size of the prefix.
+ */
+void BPlusNode::ShrinkPrefix(std::size_t size) {
+  if (size >= prefix_.size()) return;
+  const Key cut = prefix_.substr(size);
+  for (Key& key : keys_) key.insert(0, cut);
+  prefix_.resize(size);
+  RebuildHeads();
+}
+
+/**
+ * @brief Returns the index of the first stored key not less than, or greater
+ * than, the given key.
+ *
+ * A key that differs from the bytes all stored keys share sorts before or
+ * after every one of them. Otherwise the heads narrow the search down to the
+ * keys whose head equals the key's, and only those are compared as strings.
+ *
+ * @param key The key to search for, without the node's prefix.
+ * @param upper Whether to find the first greater key instead.
+ * @return The index of the found key, or Size().
+ */
+std::size_t BPlusNode::Search(KeyView key, bool upper) const {
+  if (keys_.empty()) return 0;
+  int order = key.compare(0, head_offset_, keys_.front(), 0, head_offset_);
+  if (order != 0) return order < 0 ? 0 : keys_.size();
+
+  const std::uint64_t head = Head(key.substr(head_offset_));
+  const std::size_t first = SearchHeads(head, false);
+  const std::size_t last = SearchHeads(head, true);
+  if (first == last) return first;
+  auto begin = keys_.begin() + first;
+  auto end = keys_.begin() + last;
+  auto it = upper ? std::upper_bound(begin, end, key)
+                  : std::lower_bound(begin, end, key);
+  return std::distance(keys_.begin(), it);
+}
+
+/**
+ * @brief Returns the index of the first head not less than, or greater than,
+ * the given head.
+ *
+ * The halving step picks the next window with a conditional move rather than
+ * a branch, so the search runs in a fixed number of steps for a given node
+ * size and the heads of a node fit in a few cache lines. With SSE2 the halving
+ * stops at kHeadWindow heads, and the heads left in the window are counted
+ * two per compare instead.
+ *
+ * @param head The head to search for.
+ * @param upper Whether to find the first greater head instead.
+ * @return The index of the found head, or Size().
+ */
+std::size_t BPlusNode::SearchHeads(std::uint64_t head, bool upper) const {
+  std::size_t size = heads_.size();
+  if (size == 0) return 0;
+  const std::uint64_t* base = heads_.data();
+#if defined(__SSE2__)
+  while (size > kHeadWindow) {
+    std::size_t half = size / 2;
+    bool right = upper ? base[half] <= head : base[half] < head;
+    base += right ? half : 0;
+    size -= half;
+  }
+  return static_cast<std::size_t>(base - heads_.data()) +
+         CountHeads(base, size, head, upper);
+#else
+  while (size > 1) {
+    std::size_t half = size / 2;
+    bool right = upper ? base[half] <= head : base[half] < head;
+    base += right ? half : 0;
+    size -= half;
+  }
+  bool after = upper ? *base <= head : *base < head;
+  return static_cast<std::size_t>(base - heads_.data()) + after;
+#endif
+}
+
+/**
+ * @brief Inserts a stored key at the given index and records its head.
+ *
+ * A key that shares fewer leading bytes with the others than they share among
+ * themselves shifts every head, so they are all computed again.
+ *
+ * @param idx The index to insert the key at.
+ * @param key The key, without the node's prefix.
+ */
+void BPlusNode::InsertKey(std::size_t idx, Key key) {
+  keys_.insert(keys_.begin() + idx, std::move(key));
+  const Key& other = keys_[idx == 0 ? keys_.size() - 1 : 0];
+  if (keys_.size() == 1 or CommonPrefix(keys_[idx], other) < head_offset_) {
+    RebuildHeads();
+  } else {
+    heads_.insert(heads_.begin() + idx,
+                  Head(KeyView(keys_[idx]).substr(head_offset_)));
+  }
+}
+
+/**
+ * @brief Erases the stored key at the given index and its head.
+ *
+ * The remaining keys still share the bytes the heads skip, so the other heads
+ * stay valid.
+ *
+ * @param idx The index of the key.
+ */
+void BPlusNode::EraseKey(std::size_t idx) {
+  keys_.erase(keys_.begin() + idx);
+  heads_.erase(heads_.begin() + idx);
+}
+
+/**
+ * @brief Replaces the key at the given index with a key of the same order.
+ *
+ * @param idx The index of the key.
+ * @param key The new key.
+ */
+void BPlusNode::SetKey(std::size_t idx, const Key& key) {
+  keys_[idx] = key;
+  const Key& other = keys_[idx == 0 ? keys_.size() - 1 : 0];
+  if (keys_.size() == 1 or CommonPrefix(key, other) < head_offset_) {
+    RebuildHeads();
+  } else {
+    heads_[idx] = Head(KeyView(key).substr(head_offset_));
+  }
+}
+
+/**
+ * @brief Computes the shared length of the stored keys and every head again.
+ */
+void BPlusNode::RebuildHeads() {
+  head_offset_ = keys_.empty() ? 0 : keys_.front().size();
+  for (const Key& key : keys_) {
+    head_offset_ = std::min(head_offset_, CommonPrefix(keys_.front(), key));
+  }
+  heads_.resize(keys_.size());
+  for (std::size_t i = 0; i < keys_.size(); ++i) {
+    heads_[i] = Head(KeyView(keys_[i]).substr(head_offset_));
+  }
+}
+
+/**
+ * @brief Packs the first eight bytes of a key big-endian into an integer,
+ * padding a shorter key with zero bytes.
+ *
+ * Bytes compare as unsigned char, as std::string compares them, so a smaller
+ * head always belongs to a smaller key.
+ *
+ * @param key The key.
+ * @return The head of the key.
+ */
+std::uint64_t BPlusNode::Head(KeyView key) {
+  std::uint64_t head = 0;
+  for (std::size_t i = 0; i < sizeof(head); ++i) {
+    head <<= 8;
+    if (i < key.size()) head |= static_cast<unsigned char>(key[i]);
+  }
+  return head;
+}
+
+/**
+ * @brief Returns the length of the longest common prefix of two keys.
+ */
+std::size_t BPlusNode::CommonPrefix(KeyView a, KeyView b) {
+  std::size_t size = std::min(a.size(), b.size());
+  return std::mismatch(a.begin(), a.begin() + size, b.begin()).first -
+         a.begin();
+}
+
+/**
+ * @brief Returns the shortest key that separates two adjacent keys.
+ *
+ * Internal nodes only route lookups, so a separator need not be a stored key:
+ * any s with left < s <= right sends every key to the correct side. The
+ * shortest one is the common prefix of the two keys and one more character of
+ * right.
+ *
+ * @param left The largest key of the left side.
+ * @param right The smallest key of the right side, greater than left.
+ * @return The shortest separator.
+ */
+Key BPlusNode::Separator(KeyView left, KeyView right) {
+  return Key(right.substr(0, CommonPrefix(left, right) + 1));
 }
 
 /**
@@ -54,11 +352,10 @@ bool BPlusNode::Exists(const Key& key) const {
  * @param node The child node to insert
  */
 void BPlusNode::Insert(const Key& key, NodePtr node, bool odd) {
-  auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
-  node->parent_ = shared_from_this();
-  children_.insert(children_.begin() + std::distance(keys_.begin(), it) + odd,
-                   node);
-  keys_.insert(it, key);
+  std::size_t idx = LowerBound(key);
+  node->parent_ = this;
+  children_.insert(children_.begin() + idx + odd, node);
+  InsertKey(idx, key);
 }
 
 /**
@@ -67,7 +364,8 @@ void BPlusNode::Insert(const Key& key, NodePtr node, bool odd) {
  * Inserts a new key-value pair into the leaf node. The key is inserted in
  * sorted order, and the corresponding value is inserted at the same index as
  * the key. If the key already exists in the node, the method returns false and
- * does not insert the key-value pair.
+ * does not insert the key-value pair. A key that does not start with the
+ * node's prefix first shortens the prefix to the part they share.
  *
  * @param key The key to be inserted.
  * @param value The value to be inserted.
@@ -75,12 +373,18 @@ void BPlusNode::Insert(const Key& key, NodePtr node, bool odd) {
  * key already exists in the node.
  */
 bool BPlusNode::Insert(const Key& key, const Value& value) {
-  auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
-  if (it != keys_.end() and *it == key) {
+  if (keys_.empty()) {
+    prefix_ = key;
+  } else if (key.compare(0, prefix_.size(), prefix_) != 0) {
+    ShrinkPrefix(CommonPrefix(prefix_, key));
+  }
+  std::size_t idx = LowerBound(key);
+  KeyView suffix = KeyView(key).substr(prefix_.size());
+  if (idx < keys_.size() and keys_[idx] == suffix) {
     return false;
   }
-  values_.insert(values_.begin() + std::distance(keys_.begin(), it), value);
-  keys_.insert(it, key);
+  values_.insert(values_.begin() + idx, value);
+  InsertKey(idx, Key(suffix));
   return true;
 }
 
@@ -92,12 +396,14 @@ bool BPlusNode::Insert(const Key& key, const Value& value) {
  * and updates the next pointers accordingly. If the node is an internal node,
  * it splits the child nodes and updates their parent pointers.
  *
- * @return A shared pointer to the newly created node resulting from the split.
+ * The node does not allocate: the caller supplies the empty node of the same
+ * type that receives the upper half and remains its owner. Each half of a leaf
+ * then moves the longer prefix its keys share into its own prefix.
+ *
+ * @param new_node The empty node that receives the upper half of this node.
  */
-BPlusNode::NodePtr BPlusNode::Split() {
+void BPlusNode::Split(NodePtr new_node) {
   const std::size_t mid = Size() / 2;
-  NodePtr new_node = std::make_shared<BPlusNode>(
-      IsLeaf() ? NodeType::kLeaf : NodeType::kInternal);
   std::move(keys_.begin() + mid, keys_.end(),
             std::back_inserter(new_node->keys_));
   keys_.resize(mid);
@@ -105,17 +411,23 @@ BPlusNode::NodePtr BPlusNode::Split() {
     std::move(values_.begin() + mid, values_.end(),
               std::back_inserter(new_node->values_));
     values_.resize(mid);
-    new_node->next_ = std::move(next_);
+    new_node->next_ = next_;
     next_ = new_node;
+    new_node->prefix_ = prefix_;
   } else {
     std::move(children_.begin() + mid + 1, children_.end(),
               std::back_inserter(new_node->children_));
     children_.resize(mid + 1);
-    for (NodePtr& child : new_node->children_) {
+    for (NodePtr child : new_node->children_) {
       child->parent_ = new_node;
     }
   }
-  return new_node;
+  RebuildHeads();
+  new_node->RebuildHeads();
+  if (IsLeaf()) {
+    CompressKeys();
+    new_node->CompressKeys();
+  }
 }
 
 /**
@@ -129,11 +441,10 @@ BPlusNode::NodePtr BPlusNode::Split() {
  * index (true) or the same index as the deleted key (false). Defaults to true.
  */
 void BPlusNode::Delete(const Key& key, bool odd) {
-  auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
-  if (it != keys_.end() and *it == key) {
-    auto idx = std::distance(keys_.begin(), it);
+  std::size_t idx = LowerBound(key);
+  if (idx < keys_.size() and keys_[idx] == key) {
     children_.erase(children_.begin() + idx + odd);
-    keys_.erase(it);
+    EraseKey(idx);
   }
 }
 
@@ -147,12 +458,12 @@ void BPlusNode::Delete(const Key& key, bool odd) {
  * @param key The key to remove from the leaf node.
  * @return true if the key was found and removed, false otherwise.
  */
-bool BPlusNode::Remove(const Key& key) {
-  auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
-  if (it == keys_.end() or *it != key) return false;
-  auto idx = std::distance(keys_.begin(), it);
-  keys_.erase(it);
+bool BPlusNode::Remove(KeyView key) {
+  if (!Exists(key)) return false;
+  std::size_t idx = LowerBound(key);
+  EraseKey(idx);
   values_.erase(values_.begin() + idx);
+  if (keys_.empty()) prefix_.clear();
   return true;
 }
 
@@ -169,25 +480,27 @@ bool BPlusNode::Remove(const Key& key) {
  * @param node The node that receives data from `src`.
  */
 void BPlusNode::Redistribute(NodePtr src, NodePtr node) {
-  NodePtr parent = parent_.lock();
+  NodePtr parent = parent_;
   if (!parent) return;
 
-  const Key& key = (src == node) ? src->keys_.back() : src->keys_.front();
-  const NodePtr left_node = (src == node) ? src : shared_from_this();
+  const Key key =
+      (src == node) ? src->KeyAt(src->Size() - 1) : src->KeyAt(0);
+  const NodePtr left_node = (src == node) ? src : this;
 
-  auto it = std::lower_bound(parent->children_.begin(), parent->children_.end(),
-                             left_node);
+  auto it =
+      std::find(parent->children_.begin(), parent->children_.end(), left_node);
   const auto idx = std::distance(parent->children_.begin(), it);
   if (IsLeaf()) {
-    const NodePtr right_node = (src == node) ? shared_from_this() : src;
+    const NodePtr right_node = (src == node) ? this : src;
     Insert(key, src->GetValue(key));
     src->Remove(key);
-    parent->keys_[idx] = right_node->keys_.front();
+    parent->SetKey(idx, Separator(left_node->KeyAt(left_node->Size() - 1),
+                                  right_node->KeyAt(0)));
   } else {
     const NodePtr child =
         (src == node) ? src->children_.back() : src->children_.front();
     Insert(parent->keys_[idx], child, src != node);
-    parent->keys_[idx] = key;
+    parent->SetKey(idx, key);
     src->Delete(key, src == node);
   }
 }
@@ -204,31 +517,39 @@ void BPlusNode::Redistribute(NodePtr src, NodePtr node) {
  * @param node The node to merge with the current node.
  */
 void BPlusNode::Merge(NodePtr node) {
-  NodePtr parent = parent_.lock();
+  NodePtr parent = parent_;
   if (!parent) return;
 
-  auto it = std::lower_bound(parent->children_.begin(), parent->children_.end(),
-                             node);
+  auto it = std::find(parent->children_.begin(), parent->children_.end(), node);
   const auto idx = std::distance(parent->children_.begin(), it);
 
   if (IsLeaf()) {
-    parent->keys_.erase(parent->keys_.begin() + idx - 1);
+    parent->EraseKey(idx - 1);
     parent->children_.erase(parent->children_.begin() + idx);
+    if (keys_.empty()) {
+      prefix_ = node->prefix_;
+    } else if (!node->keys_.empty()) {
+      std::size_t size = CommonPrefix(prefix_, node->prefix_);
+      ShrinkPrefix(size);
+      node->ShrinkPrefix(size);
+    }
     std::move(node->keys_.begin(), node->keys_.end(),
               std::back_inserter(keys_));
     std::move(node->values_.begin(), node->values_.end(),
               std::back_inserter(values_));
     next_ = node->next_;
+    RebuildHeads();
   } else {
     keys_.push_back(parent->keys_[idx - 1]);
     keys_.insert(keys_.end(), node->keys_.begin(), node->keys_.end());
     children_.insert(children_.end(), node->children_.begin(),
                      node->children_.end());
-    for (NodePtr& child : node->children_) {
-      child->parent_ = shared_from_this();
+    for (NodePtr child : node->children_) {
+      child->parent_ = this;
     }
     parent->children_.erase(it);
-    parent->keys_.erase(parent->keys_.begin() + idx - 1);
+    parent->EraseKey(idx - 1);
+    RebuildHeads();
   }
 }
 
@@ -239,10 +560,6 @@ void BPlusNode::Merge(NodePtr node) {
  * @return An optional Value object if the key is found, or std::nullopt
  * otherwise.
  */
-Value& BPlusNode::GetValue(const Key& key) {
-  auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
-  auto idx = std::distance(keys_.begin(), it);
-  return values_[idx];
-}
+Value& BPlusNode::GetValue(KeyView key) { return values_[LowerBound(key)]; }
 
 }  // namespace s21
@@ -2,14 +2,16 @@
 #define TRANSACTIONS_B_PLUS_TREE_B_PLUS_NODE_H_
 
 #include <algorithm>
+#include <cstdint>
 #include <fstream>
-#include <memory>
+#include <string_view>
 #include <vector>
 
 #include "../common/value.h"
 
 namespace s21 {
 using Key = std::string;
+using KeyView = std::string_view;
 
 /**
  * @brief A node in a B+ tree.
@@ -17,11 +19,23 @@ using Key = std::string;
  * This class represents a node in a B+ tree. It can be either a leaf node or an
  * internal (non-leaf) node. Leaf nodes store key-value pairs, while non-leaf
  * nodes only store keys and pointers to child nodes.
+ *
+ * Nodes link to each other through plain pointers and do not own one another:
+ * the tree that creates a node is responsible for destroying it.
+ *
+ * A leaf stores the prefix shared by all of its keys once, and keys_ holds
+ * only the rest of each key. GetKeys returns these stored suffixes; KeyAt
+ * rebuilds a full key. Internal nodes keep the prefix empty.
+ *
+ * Next to the stored keys each node keeps heads_, the first eight bytes of
+ * every key after the bytes all of its keys share, packed big-endian into an
+ * integer. Comparing heads orders keys like comparing the keys themselves
+ * unless the heads are equal, so a search runs over this dense array and
+ * compares whole strings only among the keys whose heads tie.
  */
-class BPlusNode : public std::enable_shared_from_this<BPlusNode> {
+class BPlusNode {
  public:
-  using NodePtr = std::shared_ptr<BPlusNode>;
-  using WeakPtr = std::weak_ptr<BPlusNode>;
+  using NodePtr = BPlusNode*;
 
   enum class NodeType { kLeaf, kInternal };
 
@@ -29,32 +43,45 @@ class BPlusNode : public std::enable_shared_from_this<BPlusNode> {
 
   bool IsLeaf() const;
   std::size_t Size() const;
-  bool Exists(const Key& key) const;
+  bool Exists(KeyView key) const;
+  std::size_t LowerBound(KeyView key) const;
+  std::size_t UpperBound(KeyView key) const;
+  Key KeyAt(std::size_t idx) const { return prefix_ + keys_[idx]; }
+  const Key& GetPrefix() const { return prefix_; }
+  void CompressKeys();
   void Insert(const Key& key, NodePtr node, bool odd = true);
   bool Insert(const Key& key, const Value& value);
-  NodePtr Split();
+  void Split(NodePtr new_node);
   void Delete(const Key& key, bool odd = true);
-  bool Remove(const Key& key);
+  bool Remove(KeyView key);
   void Redistribute(NodePtr src, NodePtr node);
   void Merge(NodePtr node);
-  Value& GetValue(const Key& key);
+  Value& GetValue(KeyView key);
 
-  std::vector<Key>& GetKeys() { return keys_; }
+  static Key Separator(KeyView left, KeyView right);
+
+  const std::vector<Key>& GetKeys() const { return keys_; }
   std::vector<Value>& GetValues() { return values_; }
   std::vector<NodePtr>& GetChildren() { return children_; }
-  WeakPtr GetParent() const { return parent_; }
-  void SetParent(WeakPtr parent) { parent_ = parent; }
-  void AddKey(const Key& key) { keys_.push_back(key); }
+  NodePtr GetParent() const { return parent_; }
+  void SetParent(NodePtr parent) { parent_ = parent; }
+  void AddKey(Key key) { InsertKey(keys_.size(), std::move(key)); }
   void AddValue(const Value& value) { values_.push_back(value); }
   void AddChild(NodePtr child) { children_.push_back(child); }
-  void DelKey(std::size_t idx) { keys_.erase(keys_.begin() + idx); }
+  void DelKey(std::size_t idx) { EraseKey(idx); }
   void DelValue(std::size_t idx) { values_.erase(values_.begin() + idx); }
   void DelChild(std::size_t idx) { children_.erase(children_.begin() + idx); }
-  void DelKeys() { keys_.clear(); }
+  void DelKeys() {
+    keys_.clear();
+    heads_.clear();
+  }
   void DelValues() { values_.clear(); }
   void DelChildren() { children_.clear(); }
-  void SetKey(std::size_t idx, const Key& key) { keys_[idx] = key; }
-  void SetKeys(const std::vector<Key>& keys) { keys_ = keys; }
+  void SetKey(std::size_t idx, const Key& key);
+  void SetKeys(const std::vector<Key>& keys) {
+    keys_ = keys;
+    RebuildHeads();
+  }
   void SetValue(std::size_t idx, const Value& value) { values_[idx] = value; }
   void SetValues(const std::vector<Value>& values) { values_ = values; }
   void SetChildren(const std::vector<NodePtr>& ch) { children_ = ch; }
@@ -62,11 +89,24 @@ class BPlusNode : public std::enable_shared_from_this<BPlusNode> {
   void SetNext(NodePtr next) { next_ = next; }
 
  private:
+  void ShrinkPrefix(std::size_t size);
+  std::size_t Search(KeyView key, bool upper) const;
+  std::size_t SearchHeads(std::uint64_t head, bool upper) const;
+  void InsertKey(std::size_t idx, Key key);
+  void EraseKey(std::size_t idx);
+  void RebuildHeads();
+
+  static std::uint64_t Head(KeyView key);
+  static std::size_t CommonPrefix(KeyView a, KeyView b);
+
   NodeType type_;
+  Key prefix_;
   std::vector<Key> keys_;
+  std::vector<std::uint64_t> heads_;
+  std::size_t head_offset_;
   std::vector<Value> values_;
   std::vector<NodePtr> children_;
-  WeakPtr parent_;
+  NodePtr parent_;
   NodePtr next_;
 };
 }  // namespace s21
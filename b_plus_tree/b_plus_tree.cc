@@ -7,11 +7,36 @@ namespace s21 {
  *
  * @param degree The degree of the B+ tree. Determines the maximum number of
  * children for each internal node.
+ * @param fill_factor The share of each node filled when the tree is built by
+ * Upload, in (0, 1]. Nodes are never filled below the minimum the tree keeps
+ * after deletions.
+ *
+ * @throws std::invalid_argument If the fill factor is out of range.
  */
-BPlusTree::BPlusTree(std::size_t degree)
-    : root_(std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf)),
+BPlusTree::BPlusTree(std::size_t degree, double fill_factor)
+    : root_(CreateNode(BPlusNode::NodeType::kLeaf)),
       leaf_(root_),
-      degree_(degree) {}
+      degree_(degree),
+      fill_factor_(fill_factor) {
+  if (!(fill_factor > 0.0 and fill_factor <= 1.0)) {
+    pool_.Destroy(root_);
+    throw std::invalid_argument("Invalid fill_factor");
+  }
+}
+
+/**
+ * @brief Destroys every node of the tree and returns it to the pool.
+ */
+BPlusTree::~BPlusTree() {
+  std::vector<NodePtr> stack = {root_};
+  while (!stack.empty()) {
+    NodePtr node = stack.back();
+    stack.pop_back();
+    stack.insert(stack.end(), node->GetChildren().begin(),
+                 node->GetChildren().end());
+    pool_.Destroy(node);
+  }
+}
 
 /**
  * @brief Sets the value for the specified key in the key-value store.
@@ -29,8 +54,11 @@ bool BPlusTree::Set(const Key& key, const Value& value) {
   leaf->Insert(key, value);
 
   if (leaf->Size() == degree_) {
-    NodePtr new_leaf = leaf->Split();
-    Expand(leaf, new_leaf, new_leaf->GetKeys().front());
+    NodePtr new_leaf = CreateNode(BPlusNode::NodeType::kLeaf);
+    leaf->Split(new_leaf);
+    Expand(leaf, new_leaf,
+           BPlusNode::Separator(leaf->KeyAt(leaf->Size() - 1),
+                                new_leaf->KeyAt(0)));
   }
 
   return true;
@@ -44,7 +72,7 @@ bool BPlusTree::Set(const Key& key, const Value& value) {
  * @return An optional containing the value if the key is found, or an empty
  * optional otherwise.
  */
-std::optional<Value> BPlusTree::Get(const Key& key) const {
+std::optional<Value> BPlusTree::Get(KeyView key) const {
   NodePtr leaf = FindLeaf(root_, key);
   if (leaf->Exists(key)) {
     return leaf->GetValue(key);
@@ -58,7 +86,7 @@ std::optional<Value> BPlusTree::Get(const Key& key) const {
  * @param key The key to check.
  * @return True if the key exists, false otherwise.
  */
-bool BPlusTree::Exists(const Key& key) const {
+bool BPlusTree::Exists(KeyView key) const {
   NodePtr leaf = FindLeaf(root_, key);
   return leaf->Exists(key);
 }
@@ -69,7 +97,7 @@ bool BPlusTree::Exists(const Key& key) const {
  * @param key The key to delete.
  * @return True if the record is successfully deleted, false otherwise.
  */
-bool BPlusTree::Del(const Key& key) {
+bool BPlusTree::Del(KeyView key) {
   NodePtr leaf = FindLeaf(root_, key);
   if (!leaf->Exists(key)) {
     return false;
@@ -110,13 +138,87 @@ std::vector<Key> BPlusTree::Keys() const {
   NodePtr leaf = leaf_;
 
   while (leaf) {
-    keys.insert(keys.end(), leaf->GetKeys().begin(), leaf->GetKeys().end());
+    for (std::size_t i = 0; i < leaf->Size(); ++i) {
+      keys.push_back(leaf->KeyAt(i));
+    }
     leaf = leaf->GetNext();
   }
 
   return keys;
 }
 
+/**
+ * @brief Returns up to count keys in ascending order, starting after the key
+ * stored in the cursor.
+ *
+ * The cursor is resolved to a leaf and an offset in it by a single descent
+ * from the root; the scan then follows the leaf chain. Storing a key rather
+ * than a leaf pointer keeps the cursor valid when leaves are split or merged
+ * between calls.
+ *
+ * @param cursor An empty string to start, or a cursor returned by Scan.
+ * @param count The maximum number of keys to return.
+ * @return The keys and the cursor of the next batch, empty at the end.
+ */
+AbstractStore::ScanResult BPlusTree::Scan(const std::string& cursor,
+                                          std::size_t count) const {
+  if (count == 0) count = 1;
+  NodePtr leaf = leaf_;
+  std::size_t offset = 0;
+  if (!cursor.empty()) {
+    Key after = ParseKeyCursor(cursor);
+    leaf = FindLeaf(root_, after);
+    offset = leaf->UpperBound(after);
+  }
+
+  ScanResult result;
+  while (leaf != nullptr) {
+    if (offset == leaf->Size()) {
+      leaf = leaf->GetNext();
+      offset = 0;
+    } else if (result.keys.size() < count) {
+      result.keys.push_back(leaf->KeyAt(offset++));
+    } else {
+      result.cursor = KeyCursor(result.keys.back());
+      break;
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Visits the keys from lo to hi inclusive, in ascending order.
+ *
+ * @param lo The smallest key to visit.
+ * @param hi The largest key to visit.
+ * @param visit Called with each key and its value; returning false stops the
+ * walk.
+ */
+void BPlusTree::ForEachInRange(KeyView lo, KeyView hi,
+                               const RangeVisitor& visit) const {
+  if (lo > hi) return;
+  WalkFrom(lo, [hi, &visit](const Key& key, const Value& value) {
+    return key <= hi and visit(key, value);
+  });
+}
+
+/**
+ * @brief Visits the keys that start with the prefix, in ascending order.
+ *
+ * Such keys form a contiguous run that begins at the prefix itself, so the
+ * walk starts there and stops at the first key without the prefix.
+ *
+ * @param prefix The prefix of the keys to visit.
+ * @param visit Called with each key and its value; returning false stops the
+ * walk.
+ */
+void BPlusTree::ForEachWithPrefix(KeyView prefix,
+                                  const RangeVisitor& visit) const {
+  WalkFrom(prefix, [prefix, &visit](const Key& key, const Value& value) {
+    return HasPrefix(key, prefix) and visit(key, value);
+  });
+}
+
 /**
  * @brief Renames a key in the B+ tree.
  *
@@ -142,7 +244,7 @@ bool BPlusTree::Rename(const Key& old_key, const Key& new_key) {
  * @return An optional containing the TTL if available, or an empty optional
  * otherwise.
  */
-std::optional<std::size_t> BPlusTree::TTL(const Key& key) const {
+std::optional<std::size_t> BPlusTree::TTL(KeyView key) const {
   NodePtr leaf = FindLeaf(root_, key);
   if (leaf->Exists(key)) {
     return leaf->GetValue(key).TTL();
@@ -162,10 +264,11 @@ std::vector<Key> BPlusTree::Find(const std::string& value) const {
   NodePtr leaf = leaf_;
 
   while (leaf) {
-    std::copy_if(leaf->GetKeys().begin(), leaf->GetKeys().end(),
-                 std::back_inserter(keys), [&](const Key& key) {
-                   return leaf->GetValue(key).Match(value);
-                 });
+    for (std::size_t i = 0; i < leaf->Size(); ++i) {
+      if (leaf->GetValues()[i].Match(value)) {
+        keys.push_back(leaf->KeyAt(i));
+      }
+    }
     leaf = leaf->GetNext();
   }
 
@@ -193,6 +296,9 @@ std::vector<Value> BPlusTree::ShowAll() const {
 /**
  * @brief Uploads key-value pairs from a file and inserts them into the B+ tree.
  *
+ * An empty tree is built in one pass from the whole file, see Build. A tree
+ * that already holds keys gets the records one by one through Set.
+ *
  * @param file_path The path to the file containing key-value pairs.
  * @return The number of key-value pairs uploaded successfully.
  */
@@ -204,14 +310,21 @@ std::size_t BPlusTree::Upload(const std::string& file_path) {
 
   Key key;
   std::string value;
-
-  std::size_t count = 0u;
+  std::vector<std::pair<Key, Value>> records;
   while (file >> key) {
     std::getline(file >> std::ws, value);
-    Set(key, Value::FromString(value));
-    ++count;
+    records.emplace_back(key, Value::FromString(value));
   }
   file.close();
+
+  std::size_t count = records.size();
+  if (root_->IsLeaf() and root_->Size() == 0 and degree_ > 2) {
+    Build(records);
+  } else {
+    for (auto& [record_key, record_value] : records) {
+      Set(record_key, record_value);
+    }
+  }
   return count;
 }
 
@@ -231,8 +344,9 @@ std::size_t BPlusTree::Export(const std::string& file_path) const {
   NodePtr leaf = leaf_;
 
   while (leaf) {
-    for (Key& key : leaf->GetKeys()) {
-      file << key << " " << leaf->GetValue(key).ToQuotedString() << "\n";
+    for (std::size_t i = 0; i < leaf->Size(); ++i) {
+      file << leaf->KeyAt(i) << " " << leaf->GetValues()[i].ToQuotedString()
+           << "\n";
       ++count;
     }
     leaf = leaf->GetNext();
@@ -282,7 +396,9 @@ void BPlusTree::ToDot(const std::string& file_name) const {
     if (!node) return;
     ofs << "\"" << node_names[node] << "\"";
     ofs << "[label=\"";
-    for (Key el : node->GetKeys()) ofs << el << "\\n";
+    for (std::size_t i = 0; i < node->Size(); ++i) {
+      ofs << node->KeyAt(i) << "\\n";
+    }
     ofs << "\", color=darkgreen, style=filled, fillcolor=palegreen, "
            "shape=circle]\n";
 
@@ -330,7 +446,7 @@ void BPlusTree::Show() const {
           for (std::size_t j = 0; j < level; ++j) {
             std::cout << "----";
           }
-          std::cout << "[" << node->GetKeys()[i] << "]" << std::endl;
+          std::cout << "[" << node->KeyAt(i) << "]" << std::endl;
 
           if (!node->IsLeaf()) {
             for (std::size_t j = 0; j <= level; ++j) {
@@ -348,6 +464,16 @@ void BPlusTree::Show() const {
   print_node(root_, 0);
 }
 
+/**
+ * @brief Allocates an empty node of the given type from the tree's pool.
+ *
+ * @param type The type of the node.
+ * @return The new node, owned by the tree.
+ */
+BPlusTree::NodePtr BPlusTree::CreateNode(BPlusNode::NodeType type) {
+  return pool_.Create(type);
+}
+
 /**
  * @brief Find the leaf node where the given key should be located.
  *
@@ -356,12 +482,32 @@ void BPlusTree::Show() const {
  * @return The leaf node where the key should be located.
  */
 BPlusTree::NodePtr BPlusTree::FindLeaf(BPlusTree::NodePtr node,
-                                       const Key& key) const {
-  if (node->IsLeaf()) return node;
-  auto it =
-      std::upper_bound(node->GetKeys().begin(), node->GetKeys().end(), key);
-  auto idx = std::distance(node->GetKeys().begin(), it);
-  return FindLeaf(node->GetChildren()[idx], key);
+                                       KeyView key) const {
+  while (!node->IsLeaf()) {
+    node = node->GetChildren()[node->UpperBound(key)];
+  }
+  return node;
+}
+
+/**
+ * @brief Walks the keys not less than lo in ascending order.
+ *
+ * A single descent finds the leaf that would hold lo; the walk then follows
+ * the leaf chain and ends as soon as the visitor returns false, so only the
+ * visited leaves are touched.
+ *
+ * @param lo The smallest key to visit.
+ * @param visit Called with each key and its value; returning false stops the
+ * walk.
+ */
+void BPlusTree::WalkFrom(KeyView lo, const RangeVisitor& visit) const {
+  NodePtr leaf = FindLeaf(root_, lo);
+  std::size_t offset = leaf->LowerBound(lo);
+  for (; leaf != nullptr; leaf = leaf->GetNext(), offset = 0) {
+    for (; offset < leaf->Size(); ++offset) {
+      if (!visit(leaf->KeyAt(offset), leaf->GetValues()[offset])) return;
+    }
+  }
 }
 
 /**
@@ -373,7 +519,7 @@ BPlusTree::NodePtr BPlusTree::FindLeaf(BPlusTree::NodePtr node,
  */
 void BPlusTree::Expand(NodePtr left, NodePtr right, const Key& key) {
   if (left == root_) {
-    root_ = std::make_shared<BPlusNode>(BPlusNode::NodeType::kInternal);
+    root_ = CreateNode(BPlusNode::NodeType::kInternal);
     left->SetParent(root_);
     right->SetParent(root_);
     root_->AddChild(left);
@@ -382,12 +528,13 @@ void BPlusTree::Expand(NodePtr left, NodePtr right, const Key& key) {
     return;
   }
 
-  NodePtr parent = left->GetParent().lock();
+  NodePtr parent = left->GetParent();
   parent->Insert(key, right);
 
   if (parent->Size() < degree_) return;
 
-  NodePtr new_node = parent->Split();
+  NodePtr new_node = CreateNode(BPlusNode::NodeType::kInternal);
+  parent->Split(new_node);
   Expand(parent, new_node, new_node->GetKeys().front());
   new_node->DelKey(0u);
 }
@@ -402,20 +549,20 @@ std::pair<BPlusTree::NodePtr, BPlusTree::NodePtr> BPlusTree::Adjacents(
     BPlusTree::NodePtr node) {
   NodePtr left = nullptr, right = nullptr;
 
-  NodePtr parent = node->GetParent().lock();
+  NodePtr parent = node->GetParent();
   if (parent) {
-    auto it =
-        std::upper_bound(parent->GetKeys().begin(), parent->GetKeys().end(),
-                         node->GetKeys().front());
-
-    if (it != parent->GetKeys().begin()) {
-      std::size_t idx = std::distance(parent->GetKeys().begin(), it - 1);
-      left = parent->GetChildren()[idx];
+    // The node is found by identity: its keys are stored without the leaf
+    // prefix and may all have been removed.
+    const std::vector<NodePtr>& children = parent->GetChildren();
+    std::size_t idx = std::distance(
+        children.begin(), std::find(children.begin(), children.end(), node));
+
+    if (idx > 0) {
+      left = children[idx - 1];
     }
 
-    if (it != parent->GetKeys().end()) {
-      std::size_t idx = std::distance(parent->GetKeys().begin(), it + 1);
-      right = parent->GetChildren()[idx];
+    if (idx + 1 < children.size()) {
+      right = children[idx + 1];
     }
   }
 
@@ -425,6 +572,9 @@ std::pair<BPlusTree::NodePtr, BPlusTree::NodePtr> BPlusTree::Adjacents(
 /**
  * @brief Reduce the number of keys in a node by merging with adjacent nodes.
  *
+ * Nodes emptied by a merge, and an old root that is left with a single child,
+ * are returned to the pool.
+ *
  * @param node The node to reduce.
  */
 void BPlusTree::Reduce(NodePtr node) {
@@ -432,7 +582,8 @@ void BPlusTree::Reduce(NodePtr node) {
 
   if (node == root_ and !node->IsLeaf() and node->Size() == 0) {
     root_ = node->GetChildren().front();
-    root_->GetParent().reset();
+    root_->SetParent(nullptr);
+    pool_.Destroy(node);
     return;
   }
 
@@ -449,12 +600,102 @@ void BPlusTree::Reduce(NodePtr node) {
   } else if (left) {
     if (!node->IsLeaf() and node->Size()) return;
     left->Merge(node);
-    Reduce(left->GetParent().lock());
+    pool_.Destroy(node);
+    Reduce(left->GetParent());
   } else if (right) {
     if (!node->IsLeaf() and node->Size()) return;
     node->Merge(right);
-    Reduce(node->GetParent().lock());
+    pool_.Destroy(right);
+    Reduce(node->GetParent());
   }
 }
 
+/**
+ * @brief Replaces the empty tree with one built bottom-up from the records.
+ *
+ * The records are sorted unless they already are, as files written by Export
+ * are. Of several records with the same key the first one is kept, as with
+ * Set. The sorted records are cut into leaves of equal size, close to the
+ * fill factor, and chained in order; every internal level is then cut the
+ * same way from the nodes of the level below, until one node is left. The
+ * separator in front of each child but the first is the shortest key that
+ * separates the child from the one before it.
+ *
+ * @param records The records to load; their keys and values are moved out.
+ */
+void BPlusTree::Build(std::vector<std::pair<Key, Value>>& records) {
+  SortRecords(records);
+  if (records.empty()) return;
+  pool_.Destroy(root_);
+
+  // Sizes within one level differ by at most one, and with the capacities
+  // from FillCapacity every node but a lone root gets at least as many keys
+  // as Reduce leaves after deletions.
+  std::vector<NodePtr> level;
+  std::vector<Key> separators;
+  const std::size_t leaf_size =
+      FillCapacity(2 * (degree_ / 2) - 1, degree_ - 1);
+  std::size_t leaf_count = (records.size() + leaf_size - 1) / leaf_size;
+  level.reserve(leaf_count);
+  separators.reserve(leaf_count);
+  for (std::size_t i = 0, first = 0; i < leaf_count; ++i) {
+    std::size_t last = records.size() * (i + 1) / leaf_count;
+    NodePtr leaf = CreateNode(BPlusNode::NodeType::kLeaf);
+    leaf->GetValues().reserve(last - first);
+    for (; first < last; ++first) {
+      leaf->AddKey(std::move(records[first].first));
+      leaf->GetValues().push_back(std::move(records[first].second));
+    }
+    leaf->CompressKeys();
+    if (level.empty()) {
+      separators.emplace_back();
+    } else {
+      level.back()->SetNext(leaf);
+      separators.push_back(BPlusNode::Separator(
+          level.back()->KeyAt(level.back()->Size() - 1), leaf->KeyAt(0)));
+    }
+    level.push_back(leaf);
+  }
+  leaf_ = level.front();
+
+  const std::size_t fanout =
+      FillCapacity(std::min<std::size_t>(3, degree_), degree_);
+  while (level.size() > 1) {
+    std::size_t node_count = (level.size() + fanout - 1) / fanout;
+    std::vector<NodePtr> parents;
+    std::vector<Key> parent_separators;
+    parents.reserve(node_count);
+    parent_separators.reserve(node_count);
+    for (std::size_t i = 0, first = 0; i < node_count; ++i) {
+      std::size_t last = level.size() * (i + 1) / node_count;
+      NodePtr node = CreateNode(BPlusNode::NodeType::kInternal);
+      parent_separators.push_back(std::move(separators[first]));
+      for (std::size_t j = first; j < last; ++j) {
+        if (j != first) node->AddKey(std::move(separators[j]));
+        node->AddChild(level[j]);
+        level[j]->SetParent(node);
+      }
+      first = last;
+      parents.push_back(node);
+    }
+    level = std::move(parents);
+    separators = std::move(parent_separators);
+  }
+  root_ = level.front();
+}
+
+/**
+ * @brief Returns how many entries Build puts into a node.
+ *
+ * @param min The smallest capacity that keeps every node of a level at or
+ * above the minimum fill when the entries are spread evenly.
+ * @param max The most entries a node holds without being split.
+ * @return The capacity at the fill factor, clamped to [min, max].
+ */
+std::size_t BPlusTree::FillCapacity(std::size_t min, std::size_t max) const {
+  auto capacity = static_cast<std::size_t>(
+      std::lround(fill_factor_ * static_cast<double>(max)));
+  return std::clamp(capacity, min, max);
+}
+
 }  // namespace s21
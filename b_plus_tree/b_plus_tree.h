@@ -1,10 +1,13 @@
 #ifndef TRANSACTIONS_B_PLUS_TREE_B_PLUS_TREE_H_
 #define TRANSACTIONS_B_PLUS_TREE_B_PLUS_TREE_H_
 
+#include <cmath>
+#include <functional>
 #include <iostream>
 #include <unordered_map>
 
 #include "../common/abstract_store.h"
+#include "../common/object_pool.h"
 #include "b_plus_node.h"
 
 namespace s21 {
@@ -16,39 +19,66 @@ namespace s21 {
  * binary search tree in the form of a B+ tree. It provides methods to set and
  * retrieve key-value pairs, check for existence, delete records, update values,
  * retrieve keys, rename keys, and perform various other operations.
+ *
+ * The tree owns its nodes: they are allocated from an ObjectPool and linked
+ * through plain pointers, so descending to a leaf or following the leaf chain
+ * touches no reference counts, and splitting or merging nodes reuses pool
+ * cells instead of going to the heap.
+ *
+ * Uploading into an empty tree builds it bottom-up in one pass: leaves are
+ * packed to the fill factor and each internal level is built over the one
+ * below it, see Build.
  */
 class BPlusTree : public AbstractStore {
  public:
   using NodePtr = BPlusNode::NodePtr;
 
-  explicit BPlusTree(std::size_t degree);
+  static constexpr double kDefaultFillFactor = 0.9;
+
+  explicit BPlusTree(std::size_t degree,
+                     double fill_factor = kDefaultFillFactor);
+  BPlusTree(const BPlusTree&) = delete;
+  BPlusTree& operator=(const BPlusTree&) = delete;
+  ~BPlusTree() override;
 
   bool Set(const Key& key, const Value& value) override;
-  std::optional<Value> Get(const Key& key) const override;
-  bool Exists(const Key& key) const override;
-  bool Del(const Key& key) override;
+  std::optional<Value> Get(KeyView key) const override;
+  bool Exists(KeyView key) const override;
+  bool Del(KeyView key) override;
   bool Update(const Key& key, const std::string& new_value) override;
   std::vector<Key> Keys() const override;
   bool Rename(const Key& old_key, const Key& new_key) override;
-  std::optional<std::size_t> TTL(const Key& key) const override;
+  std::optional<std::size_t> TTL(KeyView key) const override;
   std::vector<Key> Find(const std::string& value) const override;
   std::vector<Value> ShowAll() const override;
   std::size_t Upload(const std::string& file_path) override;
   std::size_t Export(const std::string& file_path) const override;
   void DeleteExpiredElements() override;
+  ScanResult Scan(const std::string& cursor, std::size_t count) const override;
+  bool HasBoundedScan() const override { return true; }
+  void ForEachInRange(KeyView lo, KeyView hi,
+                      const RangeVisitor& visit) const override;
+  void ForEachWithPrefix(KeyView prefix,
+                         const RangeVisitor& visit) const override;
 
   void ToDot(const std::string& file_name) const;
   void Show() const;
 
  private:
-  NodePtr FindLeaf(NodePtr node, const Key& key) const;
+  NodePtr CreateNode(BPlusNode::NodeType type);
+  NodePtr FindLeaf(NodePtr node, KeyView key) const;
+  void WalkFrom(KeyView lo, const RangeVisitor& visit) const;
   void Expand(NodePtr left, NodePtr right, const Key& key);
   std::pair<NodePtr, NodePtr> Adjacents(NodePtr node);
   void Reduce(NodePtr node);
+  void Build(std::vector<std::pair<Key, Value>>& records);
+  std::size_t FillCapacity(std::size_t min, std::size_t max) const;
 
+  ObjectPool<BPlusNode> pool_;
   NodePtr root_;
   NodePtr leaf_;
   std::size_t degree_;
+  double fill_factor_;
 };
 
 }  // namespace s21
@@ -1,8 +1,14 @@
 #ifndef TRANSACTIONS_ABSTRACT_STORE_H_
 #define TRANSACTIONS_ABSTRACT_STORE_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include "value.h"
@@ -10,6 +16,11 @@
 namespace s21 {
 
 using Key = std::string;
+/**
+ * @brief Non-owning key used by the read paths, so that lookups on a slice of
+ * a buffer do not have to materialize a std::string.
+ */
+using KeyView = std::string_view;
 
 /**
  * @brief An abstract class defining a key-value store interface.
@@ -18,24 +29,231 @@ using Key = std::string;
  * It is an abstract class and cannot be instantiated directly. Instead,
  * specific implementations of the key-value store can inherit from this class
  * and provide their own implementation of its pure virtual functions.
+ *
+ * Batch operations such as MGet come with a default implementation built on
+ * the single-key ones; stores override them when they can do better.
+ *
+ * Scan walks the keyspace in batches. The cursor is an opaque string: an empty
+ * cursor starts a scan, and an empty cursor in the result means the scan is
+ * complete. A key present during the whole scan is returned exactly once.
+ * Keys added or removed in the meantime may or may not be returned.
+ *
+ * Rank, Select and Range treat the keys as a sorted sequence indexed from 0,
+ * which lets a caller page through them by offset.
+ *
+ * ForEachInRange and ForEachWithPrefix stream the matching keys in ascending
+ * order to a visitor instead of collecting them, and stop as soon as the
+ * visitor returns false.
  */
 class AbstractStore {
  public:
+  struct ScanResult {
+    std::vector<Key> keys;
+    std::string cursor;
+  };
+
+  using RangeVisitor = std::function<bool(const Key&, const Value&)>;
+
   virtual ~AbstractStore() = default;
 
   virtual bool Set(const Key& key, const Value& value) = 0;
-  virtual std::optional<Value> Get(const Key& key) const = 0;
-  virtual bool Exists(const Key& key) const = 0;
-  virtual bool Del(const Key& key) = 0;
+  virtual std::optional<Value> Get(KeyView key) const = 0;
+  virtual bool Exists(KeyView key) const = 0;
+  virtual bool Del(KeyView key) = 0;
   virtual std::vector<Key> Keys() const = 0;
   virtual std::vector<Value> ShowAll() const = 0;
   virtual bool Update(const Key& key, const std::string& value) = 0;
   virtual bool Rename(const Key& old_key, const Key& new_key) = 0;
   virtual std::size_t Upload(const std::string& file_name) = 0;
   virtual std::size_t Export(const std::string& file_name) const = 0;
-  virtual std::optional<std::size_t> TTL(const Key& key) const = 0;
+  virtual std::optional<std::size_t> TTL(KeyView key) const = 0;
   virtual std::vector<Key> Find(const std::string& value) const = 0;
   virtual void DeleteExpiredElements() = 0;
+
+  virtual std::vector<std::optional<Value>> MGet(
+      const std::vector<Key>& keys) const {
+    std::vector<std::optional<Value>> values;
+    values.reserve(keys.size());
+    for (const Key& key : keys) {
+      values.push_back(Get(key));
+    }
+    return values;
+  }
+
+  /**
+   * @brief Returns up to count keys following the cursor.
+   *
+   * The default cursor is an offset into Keys(), so it materializes the whole
+   * keyspace on every call. Stores override it with a bounded walk and report
+   * that through HasBoundedScan.
+   */
+  virtual ScanResult Scan(const std::string& cursor, std::size_t count) const {
+    if (count == 0) count = 1;
+    std::size_t offset = cursor.empty() ? 0 : ParseCursor(cursor);
+    std::vector<Key> keys = Keys();
+    ScanResult result;
+    for (; offset < keys.size() and result.keys.size() < count; ++offset) {
+      result.keys.push_back(std::move(keys[offset]));
+    }
+    if (offset < keys.size()) result.cursor = std::to_string(offset);
+    return result;
+  }
+
+  /**
+   * @brief Tells whether Scan touches only about count keys per call rather
+   * than the whole keyspace, so that walking all keys in batches is cheaper
+   * than one call to Keys().
+   */
+  virtual bool HasBoundedScan() const { return false; }
+
+  /**
+   * @brief Returns the number of keys less than the given one, or std::nullopt
+   * if the key is not in the store.
+   *
+   * The defaults of Rank, Select and Range sort the whole keyspace on every
+   * call. Ordered stores override them.
+   */
+  virtual std::optional<std::size_t> Rank(KeyView key) const {
+    std::vector<Key> keys = SortedKeys();
+    auto it = std::lower_bound(keys.begin(), keys.end(), key);
+    if (it == keys.end() or *it != key) return std::nullopt;
+    return static_cast<std::size_t>(it - keys.begin());
+  }
+
+  /**
+   * @brief Returns the key with the given rank, or std::nullopt if there are
+   * not that many keys.
+   */
+  virtual std::optional<Key> Select(std::size_t rank) const {
+    std::vector<Key> keys = SortedKeys();
+    if (rank >= keys.size()) return std::nullopt;
+    return std::move(keys[rank]);
+  }
+
+  /**
+   * @brief Returns up to count keys in ascending order, starting at the given
+   * rank.
+   */
+  virtual std::vector<Key> Range(std::size_t offset, std::size_t count) const {
+    std::vector<Key> keys = SortedKeys();
+    if (offset >= keys.size()) return {};
+    auto first = keys.begin() + offset;
+    auto last = first + std::min(count, keys.size() - offset);
+    return std::vector<Key>(std::make_move_iterator(first),
+                            std::make_move_iterator(last));
+  }
+
+  /**
+   * @brief Visits the keys from lo to hi inclusive, in ascending order.
+   *
+   * The defaults of ForEachInRange and ForEachWithPrefix sort the whole
+   * keyspace on every call. Ordered stores override them with a bounded walk.
+   */
+  virtual void ForEachInRange(KeyView lo, KeyView hi,
+                              const RangeVisitor& visit) const {
+    std::vector<Key> keys = SortedKeys();
+    auto it = std::lower_bound(keys.begin(), keys.end(), lo);
+    for (; it != keys.end() and *it <= hi; ++it) {
+      std::optional<Value> value = Get(*it);
+      if (value.has_value() and !visit(*it, *value)) break;
+    }
+  }
+
+  /**
+   * @brief Visits the keys that start with the prefix, in ascending order.
+   */
+  virtual void ForEachWithPrefix(KeyView prefix,
+                                 const RangeVisitor& visit) const {
+    std::vector<Key> keys = SortedKeys();
+    auto it = std::lower_bound(keys.begin(), keys.end(), prefix);
+    for (; it != keys.end() and HasPrefix(*it, prefix); ++it) {
+      std::optional<Value> value = Get(*it);
+      if (value.has_value() and !visit(*it, *value)) break;
+    }
+  }
+
+  /**
+   * @brief Returns up to limit keys from lo to hi inclusive, in ascending
+   * order.
+   */
+  std::vector<Key> KeyRange(KeyView lo, KeyView hi, std::size_t limit) const {
+    std::vector<Key> keys;
+    if (limit == 0) return keys;
+    ForEachInRange(lo, hi, [&keys, limit](const Key& key, const Value&) {
+      keys.push_back(key);
+      return keys.size() < limit;
+    });
+    return keys;
+  }
+
+  /**
+   * @brief Returns up to limit keys that start with the prefix, in ascending
+   * order.
+   */
+  std::vector<Key> PrefixRange(KeyView prefix, std::size_t limit) const {
+    std::vector<Key> keys;
+    if (limit == 0) return keys;
+    ForEachWithPrefix(prefix, [&keys, limit](const Key& key, const Value&) {
+      keys.push_back(key);
+      return keys.size() < limit;
+    });
+    return keys;
+  }
+
+ protected:
+  static bool HasPrefix(KeyView key, KeyView prefix) {
+    return key.substr(0, prefix.size()) == prefix;
+  }
+
+  std::vector<Key> SortedKeys() const {
+    std::vector<Key> keys = Keys();
+    std::sort(keys.begin(), keys.end());
+    return keys;
+  }
+
+  /**
+   * @brief Sorts records by key unless they already are, and keeps the first
+   * of several records with the same key, as Set would.
+   */
+  static void SortRecords(std::vector<std::pair<Key, Value>>& records) {
+    auto by_key = [](const auto& a, const auto& b) {
+      return a.first < b.first;
+    };
+    if (!std::is_sorted(records.begin(), records.end(), by_key)) {
+      std::stable_sort(records.begin(), records.end(), by_key);
+    }
+    records.erase(std::unique(records.begin(), records.end(),
+                              [](const auto& a, const auto& b) {
+                                return a.first == b.first;
+                              }),
+                  records.end());
+  }
+
+  static std::uint64_t ParseCursor(const std::string& cursor) {
+    std::size_t end = 0;
+    std::uint64_t value = 0;
+    try {
+      value = std::stoull(cursor, &end);
+    } catch (const std::exception&) {
+      end = 0;
+    }
+    if (end == 0 or end != cursor.size()) {
+      throw std::invalid_argument("Invalid cursor");
+    }
+    return value;
+  }
+
+  /**
+   * @brief Cursor of ordered stores: resume after the given key.
+   */
+  static std::string KeyCursor(const Key& key) { return ">" + key; }
+
+  static Key ParseKeyCursor(const std::string& cursor) {
+    if (cursor.empty() or cursor.front() != '>') {
+      throw std::invalid_argument("Invalid cursor");
+    }
+    return cursor.substr(1);
+  }
 };
 
 }  // namespace s21
@@ -0,0 +1,97 @@
+#ifndef TRANSACTIONS_COMMON_OBJECT_POOL_H_
+#define TRANSACTIONS_COMMON_OBJECT_POOL_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+
+/**
+ * @brief Slab allocator for objects of a single type.
+ *
+ * Objects are constructed in place inside large slabs, so creating one costs a
+ * pointer bump or a free-list pop instead of a heap allocation. Destroyed
+ * objects return their cell to an intrusive free list and the cell is reused by
+ * the next Create. Slabs are released only when the pool itself is destroyed.
+ *
+ * The pool does not track which cells are alive: every object obtained from
+ * Create must be passed to Destroy before the pool goes away.
+ */
+template <typename T>
+class ObjectPool {
+ public:
+  static constexpr std::size_t kDefaultSlabSize = 256;
+
+  explicit ObjectPool(std::size_t slab_size = kDefaultSlabSize)
+      : slab_size_(slab_size == 0 ? 1 : slab_size),
+        used_in_slab_(slab_size_),
+        free_list_(nullptr),
+        size_(0) {}
+
+  ObjectPool(const ObjectPool&) = delete;
+  ObjectPool& operator=(const ObjectPool&) = delete;
+
+  ObjectPool(ObjectPool&& other) noexcept
+      : slabs_(std::move(other.slabs_)),
+        slab_size_(other.slab_size_),
+        used_in_slab_(std::exchange(other.used_in_slab_, other.slab_size_)),
+        free_list_(std::exchange(other.free_list_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+
+  ObjectPool& operator=(ObjectPool&& other) noexcept {
+    slabs_ = std::move(other.slabs_);
+    slab_size_ = other.slab_size_;
+    used_in_slab_ = std::exchange(other.used_in_slab_, other.slab_size_);
+    free_list_ = std::exchange(other.free_list_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    return *this;
+  }
+
+  template <typename... Args>
+  T* Create(Args&&... args) {
+    Cell* cell = free_list_;
+    if (cell != nullptr) {
+      free_list_ = cell->next;
+    } else {
+      if (used_in_slab_ == slab_size_) {
+        slabs_.emplace_back(new Cell[slab_size_]);
+        used_in_slab_ = 0;
+      }
+      cell = &slabs_.back()[used_in_slab_++];
+    }
+    T* object = new (cell->storage) T(std::forward<Args>(args)...);
+    ++size_;
+    return object;
+  }
+
+  void Destroy(T* object) {
+    if (object == nullptr) return;
+    object->~T();
+    Cell* cell = reinterpret_cast<Cell*>(object);
+    cell->next = free_list_;
+    free_list_ = cell;
+    --size_;
+  }
+
+  std::size_t Size() const { return size_; }
+  std::size_t Slabs() const { return slabs_.size(); }
+
+ private:
+  union Cell {
+    Cell* next;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+  std::vector<std::unique_ptr<Cell[]>> slabs_;
+  std::size_t slab_size_;
+  std::size_t used_in_slab_;
+  Cell* free_list_;
+  std::size_t size_;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_COMMON_OBJECT_POOL_H_
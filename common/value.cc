@@ -1,7 +1,38 @@
 #include "value.h"
 
+#include <cstdint>
+
 namespace s21 {
 
+namespace {
+
+void PutField(std::string &bytes, const std::string &field) {
+  std::uint32_t size = static_cast<std::uint32_t>(field.size());
+  for (int shift = 0; shift < 32; shift += 8) {
+    bytes.push_back(static_cast<char>(size >> shift));
+  }
+  bytes += field;
+}
+
+std::string GetField(std::string_view &bytes) {
+  if (bytes.size() < 4) {
+    throw std::invalid_argument("Truncated value bytes");
+  }
+  std::uint32_t size = 0;
+  for (int i = 0; i < 4; ++i) {
+    size |= std::uint32_t(static_cast<unsigned char>(bytes[i])) << (8 * i);
+  }
+  bytes.remove_prefix(4);
+  if (bytes.size() < size) {
+    throw std::invalid_argument("Truncated value bytes");
+  }
+  std::string field(bytes.substr(0, size));
+  bytes.remove_prefix(size);
+  return field;
+}
+
+}  // namespace
+
 Value::Value(const std::string &last_name, const std::string &first_name,
              const std::string &birth_year, const std::string &city,
              const std::string &coins, std::optional<std::string> ttl)
@@ -70,6 +101,43 @@ Value Value::FromString(std::string value) {
   return Value(last_name, first_name, birth_year, city, coins);
 }
 
+std::string Value::ToBytes() const {
+  std::string bytes;
+  PutField(bytes, last_name_);
+  PutField(bytes, first_name_);
+  PutField(bytes, birth_year_);
+  PutField(bytes, city_);
+  PutField(bytes, coins_);
+  bytes.push_back(ttl_.has_value() ? 1 : 0);
+  if (ttl_.has_value()) PutField(bytes, *ttl_);
+  auto created = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     creation_time_.time_since_epoch())
+                     .count();
+  PutField(bytes, std::to_string(created));
+  return bytes;
+}
+
+Value Value::FromBytes(std::string_view bytes) {
+  Value value;
+  value.last_name_ = GetField(bytes);
+  value.first_name_ = GetField(bytes);
+  value.birth_year_ = GetField(bytes);
+  value.city_ = GetField(bytes);
+  value.coins_ = GetField(bytes);
+  if (bytes.empty()) {
+    throw std::invalid_argument("Truncated value bytes");
+  }
+  bool has_ttl = bytes.front() != 0;
+  bytes.remove_prefix(1);
+  if (has_ttl) value.ttl_ = GetField(bytes);
+  std::chrono::nanoseconds created(std::stoll(GetField(bytes)));
+  value.creation_time_ =
+      std::chrono::time_point<std::chrono::system_clock>(
+          std::chrono::duration_cast<std::chrono::system_clock::duration>(
+              created));
+  return value;
+}
+
 bool Value::Match(const std::string &value) const {
   std::istringstream ss(value);
   auto [last_name, first_name, birth_year, city, coins, ttl] =
@@ -6,6 +6,7 @@
 #include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <tuple>
 
 namespace s21 {
@@ -17,6 +18,10 @@ namespace s21 {
  * first name, birth year, city, and number of coins. It also supports an
  * optional time-to-live (TTL) parameter, which specifies how long the value
  * should be stored in the key-value store before it is automatically deleted.
+ *
+ * ToBytes and FromBytes convert a value to a compact binary form and back,
+ * keeping the TTL and the creation time, for stores that keep their records
+ * on disk.
  */
 class Value {
  public:
@@ -33,6 +38,8 @@ class Value {
   std::string ToQuotedString() const;
   std::string ToString() const;
   static Value FromString(std::string value);
+  std::string ToBytes() const;
+  static Value FromBytes(std::string_view bytes);
   bool Match(const std::string &value) const;
   bool operator==(const Value &other) const;
 
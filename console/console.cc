@@ -10,6 +10,10 @@ void Console::Run() {
   AddItem({"Choose key-value store", [this] { ChooseStore(); }});
   AddItem({"Enter command", [this] { EnterCommand(); }});
   AddItem({"Run research", [this] { RunResearch(); }});
+  AddItem({"Run scaling research", [this] { RunScalingResearch(); }});
+  AddItem({"Run hash research", [this] { RunHashResearch(); }});
+  AddItem({"Run load factor research", [this] { RunLoadResearch(); }});
+  AddItem({"Run upload research", [this] { RunUploadResearch(); }});
   AddItem({"Print help", [this] { PrintHelp(); }});
   MainLoop();
 }
@@ -18,7 +22,7 @@ void Console::ChooseStore() {
   std::string text;
   system("clear");
   ChooseStoreMenu();
-  int choice = InputNumber(3, Menu::kChooseStore);
+  int choice = InputNumber(9, Menu::kChooseStore);
   system("clear");
 
   if (choice == 1) {
@@ -33,6 +37,32 @@ void Console::ChooseStore() {
     store_ = std::make_unique<BPlusTree>(kDegree);
     type_ = "B+ tree";
     text = "Switched to B+ tree store.";
+  } else if (choice == 4) {
+    store_ = std::make_unique<SwissTable>();
+    type_ = "Swiss table";
+    text = "Switched to Swiss table store.";
+  } else if (choice == 5) {
+    store_ = std::make_unique<ConcurrentHashTable>();
+    type_ = "Concurrent hash table";
+    text = "Switched to concurrent hash table store.";
+  } else if (choice == 6) {
+    store_ = std::make_unique<ShardedStore>();
+    type_ = "Sharded hash table";
+    text = "Switched to sharded hash table store.";
+  } else if (choice == 7) {
+    store_ = std::make_unique<CuckooHashTable>();
+    type_ = "Cuckoo hash table";
+    text = "Switched to cuckoo hash table store.";
+  } else if (choice == 8) {
+    store_ = std::make_unique<PersistentTree>();
+    type_ = "Persistent AVL tree";
+    text = "Switched to persistent AVL tree store.";
+  } else if (choice == 9) {
+    store_.reset();
+    store_ = std::make_unique<PagedBPlusTree>(kPagedTreeFile);
+    type_ = "Paged B+ tree";
+    text = "Switched to paged B+ tree store in " + std::string(kPagedTreeFile) +
+           ".";
   }
   if (!text.empty()) {
     PrintMessage(text, Color::kMagenta);
@@ -65,6 +95,8 @@ void Console::EnterCommand() {
       Set(tokens);
     } else if (cmd == "GET") {
       Get(tokens);
+    } else if (cmd == "MGET") {
+      MGet(tokens);
     } else if (cmd == "EXISTS") {
       Exists(tokens);
     } else if (cmd == "DEL") {
@@ -73,6 +105,18 @@ void Console::EnterCommand() {
       Update(tokens);
     } else if (cmd == "KEYS") {
       Keys(tokens);
+    } else if (cmd == "SCAN") {
+      Scan(tokens);
+    } else if (cmd == "RANK") {
+      Rank(tokens);
+    } else if (cmd == "SELECT") {
+      Select(tokens);
+    } else if (cmd == "RANGE") {
+      Range(tokens);
+    } else if (cmd == "KEYRANGE") {
+      KeyRange(tokens);
+    } else if (cmd == "PREFIX") {
+      Prefix(tokens);
     } else if (cmd == "RENAME") {
       Rename(tokens);
     } else if (cmd == "TTL") {
@@ -135,6 +179,21 @@ void Console::Get(const std::vector<std::string>& tokens) {
   }
 }
 
+void Console::MGet(const std::vector<std::string>& tokens) {
+  if (tokens.size() >= 2) {
+    std::vector<Key> keys(tokens.begin() + 1, tokens.end());
+    std::vector<std::optional<Value>> values = store_->MGet(keys);
+    std::size_t idx = 1;
+    for (auto& value : values) {
+      std::cout << "> " << idx << ") "
+                << (value.has_value() ? value->ToString() : "(null)") << "\n";
+      ++idx;
+    }
+  } else {
+    std::cout << "> ERROR: invalid MGET command\n";
+  }
+}
+
 void Console::Exists(const std::vector<std::string>& tokens) {
   if (tokens.size() == 2) {
     std::string key = tokens[1];
@@ -185,21 +244,170 @@ void Console::Update(const std::vector<std::string>& tokens) {
 
 void Console::Keys(const std::vector<std::string>& tokens) {
   if (tokens.size() == 1) {
-    std::vector<std::string> keys = store_->Keys();
-    if (keys.empty()) {
-      std::cout << "> (null)\n";
+    // Stores with a bounded Scan hand out the keys batch by batch, so the
+    // whole keyspace never has to be held in memory at once. For the others
+    // every Scan call copies all the keys, so they are fetched once instead.
+    constexpr std::size_t kBatchSize = 1000;
+    std::size_t idx = 1;
+    auto print = [&idx](const std::vector<Key>& keys) {
+      for (const Key& key : keys) {
+        std::cout << "> " << idx << ") " << key << "\n";
+        ++idx;
+      }
+    };
+    if (store_->HasBoundedScan()) {
+      AbstractStore::ScanResult batch;
+      do {
+        batch = store_->Scan(batch.cursor, kBatchSize);
+        print(batch.keys);
+      } while (!batch.cursor.empty());
     } else {
+      print(store_->Keys());
+    }
+    if (idx == 1) {
+      std::cout << "> (null)\n";
+    }
+    std::cout.flush();
+  } else {
+    std::cout << "> ERROR: invalid KEYS command\n";
+  }
+}
+
+void Console::Scan(const std::vector<std::string>& tokens) {
+  constexpr std::size_t kDefaultCount = 10;
+  if (tokens.size() == 2 or (tokens.size() == 4 and tokens[2] == "COUNT")) {
+    try {
+      std::string cursor = tokens[1] == "0" ? "" : tokens[1];
+      std::size_t count =
+          tokens.size() == 4 ? std::stoul(tokens[3]) : kDefaultCount;
+      AbstractStore::ScanResult batch = store_->Scan(cursor, count);
+      std::cout << "> cursor: "
+                << (batch.cursor.empty() ? "0" : batch.cursor) << "\n";
       std::size_t idx = 1;
-      for (auto& key : keys) {
-        std::cout << "> " << idx << ") " << key << std::endl;
+      for (auto& key : batch.keys) {
+        std::cout << "> " << idx << ") " << key << "\n";
         ++idx;
       }
+    } catch (const std::exception& e) {
+      std::cout << "> ";
+      std::cout << e.what() << "\n";
     }
   } else {
-    std::cout << "> ERROR: invalid KEYS command\n";
+    std::cout << "> ERROR: invalid SCAN command\n";
+  }
+}
+
+void Console::Rank(const std::vector<std::string>& tokens) {
+  if (tokens.size() == 2) {
+    std::string key = tokens[1];
+    std::optional<std::size_t> rank = store_->Rank(key);
+    if (rank.has_value()) {
+      std::cout << "> " << rank.value() << "\n";
+    } else {
+      std::cout << "> (null)\n";
+    }
+  } else {
+    std::cout << "> ERROR: invalid RANK command\n";
+  }
+}
+
+void Console::Select(const std::vector<std::string>& tokens) {
+  if (tokens.size() == 2) {
+    try {
+      std::size_t rank = std::stoul(tokens[1]);
+      std::optional<Key> key = store_->Select(rank);
+      if (key.has_value()) {
+        std::cout << "> " << key.value() << "\n";
+      } else {
+        std::cout << "> (null)\n";
+      }
+    } catch (const std::exception& e) {
+      std::cout << "> ";
+      std::cout << e.what() << "\n";
+    }
+  } else {
+    std::cout << "> ERROR: invalid SELECT command\n";
   }
 }
 
+void Console::Range(const std::vector<std::string>& tokens) {
+  if (tokens.size() == 3) {
+    try {
+      std::size_t offset = std::stoul(tokens[1]);
+      std::size_t count = std::stoul(tokens[2]);
+      std::vector<Key> keys = store_->Range(offset, count);
+      if (keys.empty()) {
+        std::cout << "> (null)\n";
+      } else {
+        std::size_t idx = offset + 1;
+        for (auto& key : keys) {
+          std::cout << "> " << idx << ") " << key << "\n";
+          ++idx;
+        }
+      }
+    } catch (const std::exception& e) {
+      std::cout << "> ";
+      std::cout << e.what() << "\n";
+    }
+  } else {
+    std::cout << "> ERROR: invalid RANGE command\n";
+  }
+}
+
+void Console::KeyRange(const std::vector<std::string>& tokens) {
+  if (tokens.size() == 3 or (tokens.size() == 5 and tokens[3] == "LIMIT")) {
+    try {
+      std::size_t limit = tokens.size() == 5
+                              ? std::stoul(tokens[4])
+                              : std::numeric_limits<std::size_t>::max();
+      PrintKeys(limit, [&](const AbstractStore::RangeVisitor& visit) {
+        store_->ForEachInRange(tokens[1], tokens[2], visit);
+      });
+    } catch (const std::exception& e) {
+      std::cout << "> ";
+      std::cout << e.what() << "\n";
+    }
+  } else {
+    std::cout << "> ERROR: invalid KEYRANGE command\n";
+  }
+}
+
+void Console::Prefix(const std::vector<std::string>& tokens) {
+  if (tokens.size() == 2 or (tokens.size() == 4 and tokens[2] == "LIMIT")) {
+    try {
+      std::size_t limit = tokens.size() == 4
+                              ? std::stoul(tokens[3])
+                              : std::numeric_limits<std::size_t>::max();
+      PrintKeys(limit, [&](const AbstractStore::RangeVisitor& visit) {
+        store_->ForEachWithPrefix(tokens[1], visit);
+      });
+    } catch (const std::exception& e) {
+      std::cout << "> ";
+      std::cout << e.what() << "\n";
+    }
+  } else {
+    std::cout << "> ERROR: invalid PREFIX command\n";
+  }
+}
+
+void Console::PrintKeys(
+    std::size_t limit,
+    const std::function<void(const AbstractStore::RangeVisitor&)>& walk) {
+  // The keys are printed as the store visits them, so the result is never
+  // collected into a vector.
+  std::size_t idx = 1;
+  if (limit > 0) {
+    walk([&idx, limit](const Key& key, const Value&) {
+      std::cout << "> " << idx << ") " << key << "\n";
+      return idx++ < limit;
+    });
+  }
+  if (idx == 1) {
+    std::cout << "> (null)\n";
+  }
+  std::cout.flush();
+}
+
 void Console::Rename(const std::vector<std::string>& tokens) {
   if (tokens.size() == 3) {
     std::string old_key = tokens[1];
@@ -322,6 +530,8 @@ void Console::PrintHelp() const {
          "\t\t- Adds a key-value pair to the storage.\n"
          "\tGET\t: GET <key>\n"
          "\t\t- Retrieves the value associated with the key.\n"
+         "\tMGET\t: MGET <key1> <key2> ...\n"
+         "\t\t- Retrieves the values of several keys in one batch.\n"
          "\tEXISTS\t: EXISTS <key>\n"
          "\t\t- Checks if a record with the given key exists.\n"
          "\tDEL\t: DEL <key>\n"
@@ -332,6 +542,22 @@ void Console::PrintHelp() const {
          "fields that should not be changed.\n"
          "\tKEYS\t: KEYS\n"
          "\t\t- Returns all the keys in the store.\n"
+         "\tSCAN\t: SCAN <cursor> COUNT <count>\n"
+         "\t\t- Returns the next batch of keys and the cursor to continue "
+         "from. Start with cursor 0; a returned cursor of 0 ends the scan.\n"
+         "\tRANK\t: RANK <key>\n"
+         "\t\t- Returns the position of the key in sorted order, from 0.\n"
+         "\tSELECT\t: SELECT <rank>\n"
+         "\t\t- Returns the key at the given position in sorted order.\n"
+         "\tRANGE\t: RANGE <offset> <count>\n"
+         "\t\t- Returns up to count keys in sorted order, starting at the "
+         "offset.\n"
+         "\tKEYRANGE: KEYRANGE <from> <to> LIMIT <count>\n"
+         "\t\t- Returns the keys from <from> to <to> inclusive in sorted "
+         "order. LIMIT is optional.\n"
+         "\tPREFIX\t: PREFIX <prefix> LIMIT <count>\n"
+         "\t\t- Returns the keys that start with the prefix in sorted order. "
+         "LIMIT is optional.\n"
          "\tRENAME\t: RENAME <old_key> <new_key>\n"
          "\t\t- Renames keys.\n"
          "\tTTL\t: TTL <key>\n"
@@ -404,6 +630,40 @@ void Console::RunResearch() {
               << duration.count() / iter_cnt << " μs\n";
   }
 
+  // Measure time for getting a batch of items, one by one and with MGET
+  {
+    constexpr int kBatchSize = 100;
+    std::vector<std::vector<Key>> batches(iter_cnt);
+    for (auto& batch : batches) {
+      for (int i = 0; i < kBatchSize; ++i) {
+        batch.push_back(keys[std::rand() % items_cnt]);
+      }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& batch : batches) {
+      for (const Key& key : batch) {
+        store_->Get(key);
+      }
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (const auto& batch : batches) {
+      store_->MGet(batch);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto get_time =
+        std::chrono::duration_cast<std::chrono::microseconds>(middle - start);
+    auto mget_time =
+        std::chrono::duration_cast<std::chrono::microseconds>(end - middle);
+    std::cout << "Average time for getting " << kBatchSize
+              << " items one by one: " << get_time.count() / iter_cnt
+              << " μs\n"
+              << "Average time for getting " << kBatchSize
+              << " items with MGET: " << mget_time.count() / iter_cnt
+              << " μs\n";
+  }
+
   // Measure time for getting a list of all elements
   {
     auto start = std::chrono::steady_clock::now();
@@ -446,6 +706,233 @@ void Console::RunResearch() {
   }
 }
 
+void Console::RunScalingResearch() {
+  std::cout << "Enter the number of items in the store (1 - 1M): ";
+  int items_cnt = InputNumber(1e6, Menu::kResearch);
+
+  std::cout << "Enter the number of operations per thread (1 - 1M): ";
+  int ops_cnt = InputNumber(1e6, Menu::kResearch);
+
+  std::vector<std::string> keys(items_cnt);
+  std::generate(keys.begin(), keys.end(),
+                [n = 0]() mutable { return "key" + std::to_string(n++); });
+  Value value("Last", "First", "2000", "City", "100");
+
+  unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<unsigned> threads_counts;
+  for (unsigned n = 1; n < max_threads; n *= 2) threads_counts.push_back(n);
+  threads_counts.push_back(max_threads);
+
+  using StoreFactory = std::function<std::unique_ptr<AbstractStore>()>;
+  std::vector<std::pair<std::string, StoreFactory>> stores = {
+      {"Concurrent hash table",
+       [] { return std::make_unique<ConcurrentHashTable>(); }},
+      {"Sharded hash table", [] { return std::make_unique<ShardedStore>(); }}};
+
+  for (const auto& [name, factory] : stores) {
+    std::cout << name << ":\n";
+    double base_throughput = 0.0;
+    for (unsigned threads_cnt : threads_counts) {
+      std::unique_ptr<AbstractStore> store = factory();
+      for (int i = 0; i < items_cnt; i += 2) {
+        store->Set(keys[i], value);
+      }
+
+      // Every thread runs a read-mostly mix: 90% GET, 5% SET and 5% DEL.
+      auto worker = [&](unsigned seed) {
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<> key_dst(0, items_cnt - 1);
+        std::uniform_int_distribution<> op_dst(0, 99);
+        for (int i = 0; i < ops_cnt; ++i) {
+          const std::string& key = keys[key_dst(gen)];
+          int op = op_dst(gen);
+          if (op < 90) {
+            store->Get(key);
+          } else if (op < 95) {
+            store->Set(key, value);
+          } else {
+            store->Del(key);
+          }
+        }
+      };
+
+      std::vector<std::thread> threads;
+      auto start = std::chrono::steady_clock::now();
+      for (unsigned t = 0; t < threads_cnt; ++t) {
+        threads.emplace_back(worker, t + 1);
+      }
+      for (std::thread& thread : threads) {
+        thread.join();
+      }
+      auto end = std::chrono::steady_clock::now();
+      auto duration =
+          std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+      double throughput = static_cast<double>(ops_cnt) * threads_cnt /
+                          std::max<long long>(1, duration.count());
+      if (threads_cnt == 1) base_throughput = throughput;
+      std::cout << "\tThreads: " << threads_cnt << ", throughput: "
+                << throughput << " ops/μs, speedup: "
+                << throughput / base_throughput << "x\n";
+    }
+  }
+}
+
+void Console::RunHashResearch() {
+  std::cout << "Enter the number of items in the store (1 - 1M): ";
+  int items_cnt = InputNumber(1e6, Menu::kResearch);
+
+  // Keys share a long prefix, like the tenant-scoped keys seen in production.
+  std::vector<std::string> keys(items_cnt);
+  std::generate(keys.begin(), keys.end(), [n = 0]() mutable {
+    return "tenant:region:user:" + std::to_string(n++);
+  });
+  Value value("Last", "First", "2000", "City", "100");
+
+  for (const NamedHasher& named : kHashers) {
+    HashTable store(HashTable::kDefaultCapacity, named.hasher);
+
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string& key : keys) {
+      store.Set(key, value);
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (const std::string& key : keys) {
+      store.Exists(key);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto set_time =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(middle - start);
+    auto get_time =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - middle);
+    std::cout << named.name << ":\n"
+              << "\tAverage time for adding an item: "
+              << set_time.count() / items_cnt << " ns\n"
+              << "\tAverage time for getting an item: "
+              << get_time.count() / items_cnt << " ns\n"
+              << "\tChain lengths (length: buckets):";
+    std::vector<std::size_t> chains = store.ChainLengths();
+    for (std::size_t length = 0; length < chains.size(); ++length) {
+      if (chains[length] != 0) {
+        std::cout << " " << length << ": " << chains[length] << ";";
+      }
+    }
+    std::cout << "\n";
+  }
+}
+
+void Console::RunLoadResearch() {
+  std::cout << "Enter the number of items in the store (1 - 1M): ";
+  int items_cnt = InputNumber(1e6, Menu::kResearch);
+
+  std::vector<std::string> keys(items_cnt);
+  std::generate(keys.begin(), keys.end(),
+                [n = 0]() mutable { return "key" + std::to_string(n++); });
+  Value value("Last", "First", "2000", "City", "100");
+
+  // Occupancy is records per slot for the open-addressing tables and records
+  // per bucket for the chained table, which also allocates a node per record.
+  auto measure = [&](const std::string& name, auto& store) {
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string& key : keys) {
+      store.Set(key, value);
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (const std::string& key : keys) {
+      store.Exists(key);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto set_time =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(middle - start);
+    auto get_time =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - middle);
+    std::cout << name << ":\n"
+              << "\tAverage time for adding an item: "
+              << set_time.count() / items_cnt << " ns\n"
+              << "\tAverage time for getting an item: "
+              << get_time.count() / items_cnt << " ns\n"
+              << "\tOccupancy: " << store.Size() << " / " << store.Capacity()
+              << " = " << static_cast<double>(store.Size()) / store.Capacity()
+              << "\n";
+  };
+
+  {
+    HashTable store;
+    measure("Hash table", store);
+  }
+  {
+    SwissTable store;
+    measure("Swiss table", store);
+  }
+  {
+    CuckooHashTable store;
+    measure("Cuckoo hash table", store);
+  }
+}
+
+void Console::RunUploadResearch() {
+  std::cout << "Enter the number of items in the store (1 - 1M): ";
+  int items_cnt = InputNumber(1e6, Menu::kResearch);
+
+  std::vector<std::string> keys(items_cnt);
+  std::generate(keys.begin(), keys.end(),
+                [n = 0]() mutable { return "key" + std::to_string(n++); });
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(std::random_device()()));
+  Value value("Last", "First", "2000", "City", "100");
+
+  const std::string shuffled_file = "upload_research_shuffled.dat";
+  const std::string sorted_file = "upload_research_sorted.dat";
+  {
+    std::ofstream file(shuffled_file);
+    if (!file.is_open()) throw std::invalid_argument("File can't be opened");
+    for (const std::string& key : keys) {
+      file << key << " " << value.ToQuotedString() << "\n";
+    }
+  }
+  {
+    SelfBalancingBinarySearchTree store;
+    store.Upload(shuffled_file);
+    store.Export(sorted_file);
+  }
+
+  // An empty tree is built in bulk. A tree that already holds a key takes the
+  // records one by one, which is how every upload used to work.
+  auto measure = [&](const std::string& name,
+                     std::unique_ptr<AbstractStore> store,
+                     const std::string& file_name, bool per_key) {
+    if (per_key) store->Set("~", value);
+    auto start = std::chrono::steady_clock::now();
+    store->Upload(file_name);
+    auto end = std::chrono::steady_clock::now();
+
+    auto time =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    std::cout << name << ":\n"
+              << "\tAverage time for uploading an item: "
+              << time.count() / items_cnt << " ns\n";
+  };
+
+  for (bool sorted : {true, false}) {
+    const std::string& file_name = sorted ? sorted_file : shuffled_file;
+    const std::string suffix = sorted ? ", sorted file" : ", shuffled file";
+    measure("AVL tree, per-key upload" + suffix,
+            std::make_unique<SelfBalancingBinarySearchTree>(), file_name,
+            true);
+    measure("AVL tree, bulk upload" + suffix,
+            std::make_unique<SelfBalancingBinarySearchTree>(), file_name,
+            false);
+    measure("B+ tree, per-key upload" + suffix,
+            std::make_unique<BPlusTree>(kDegree), file_name, true);
+    measure("B+ tree, bulk upload" + suffix,
+            std::make_unique<BPlusTree>(kDegree), file_name, false);
+  }
+
+  std::remove(shuffled_file.c_str());
+  std::remove(sorted_file.c_str());
+}
+
 void Console::ShowMenu(Menu menu) const {
   if (menu == Menu::kMain) MainMenu();
   if (menu == Menu::kChooseStore) ChooseStoreMenu();
@@ -472,6 +959,12 @@ void Console::ChooseStoreMenu() const {
   std::cout << "    1. Hash table\n";
   std::cout << "    2. Self-balancing binary search tree\n";
   std::cout << "    3. B+ tree\n";
+  std::cout << "    4. Swiss table\n";
+  std::cout << "    5. Concurrent hash table\n";
+  std::cout << "    6. Sharded hash table\n";
+  std::cout << "    7. Cuckoo hash table\n";
+  std::cout << "    8. Persistent AVL tree\n";
+  std::cout << "    9. Paged B+ tree\n";
   std::cout << "    0. Back to menu\n\n";
   PrintMessage(" ", Color::kCyan);
   std::cout << "\n\n> ";
@@ -480,7 +973,7 @@ void Console::ChooseStoreMenu() const {
 void Console::MainLoop() {
   while (true) {
     ShowMenu(Menu::kMain);
-    int choice = InputNumber(4, Menu::kMain) - 1;
+    int choice = InputNumber(static_cast<int>(menu_.size()), Menu::kMain) - 1;
     if (choice == -1) break;
     try {
       menu_[choice].item();
@@ -1,17 +1,26 @@
 #ifndef TRANSACTIONS_CONSOLE_CONSOLE_H_
 #define TRANSACTIONS_CONSOLE_CONSOLE_H_
 
+#include <cstdio>
 #include <exception>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <iterator>
 #include <limits>
 #include <random>
+#include <thread>
 #include <vector>
 
 #include "../avl_tree/self_balancing_binary_search_tree.h"
 #include "../b_plus_tree/b_plus_tree.h"
+#include "../cuckoo_hash/cuckoo_hash_table.h"
+#include "../hash_table/concurrent_hash_table.h"
 #include "../hash_table/hash_table.h"
+#include "../paged_b_plus_tree/paged_b_plus_tree.h"
+#include "../persistent_tree/persistent_tree.h"
+#include "../sharded_store/sharded_store.h"
+#include "../swiss_table/swiss_table.h"
 
 namespace s21 {
 
@@ -24,6 +33,7 @@ struct Item {
 };
 
 constexpr std::size_t kDegree = 10;
+constexpr const char* kPagedTreeFile = "./paged_b_plus_tree.db";
 
 class Console {
  public:
@@ -33,12 +43,26 @@ class Console {
   void ChooseStore();
   void EnterCommand();
   void RunResearch();
+  void RunScalingResearch();
+  void RunHashResearch();
+  void RunLoadResearch();
+  void RunUploadResearch();
   void Set(const std::vector<std::string>& tokens);
   void Get(const std::vector<std::string>& tokens);
+  void MGet(const std::vector<std::string>& tokens);
   void Exists(const std::vector<std::string>& tokens);
   void Del(const std::vector<std::string>& tokens);
   void Update(const std::vector<std::string>& tokens);
   void Keys(const std::vector<std::string>& tokens);
+  void Scan(const std::vector<std::string>& tokens);
+  void Rank(const std::vector<std::string>& tokens);
+  void Select(const std::vector<std::string>& tokens);
+  void Range(const std::vector<std::string>& tokens);
+  void KeyRange(const std::vector<std::string>& tokens);
+  void Prefix(const std::vector<std::string>& tokens);
+  void PrintKeys(
+      std::size_t limit,
+      const std::function<void(const AbstractStore::RangeVisitor&)>& walk);
   void Rename(const std::vector<std::string>& tokens);
   void TTL(const std::vector<std::string>& tokens);
   void Find(const std::vector<std::string>& tokens);
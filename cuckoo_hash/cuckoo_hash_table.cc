@@ -0,0 +1,381 @@
+#include "cuckoo_hash_table.h"
+
+#include <algorithm>
+
+#include "../hash_table/hash_functions.h"
+
+namespace s21 {
+
+/**
+ * @brief Constructs an empty cuckoo hash table.
+ *
+ * @param capacity The initial number of slots. It is rounded up to whole
+ * buckets and is never less than kMinCapacity.
+ */
+CuckooHashTable::CuckooHashTable(std::size_t capacity)
+    : buckets_((std::max(capacity, kMinCapacity) + kBucketSlots - 1) /
+               kBucketSlots),
+      size_(0),
+      tags_(buckets_ * kBucketSlots, kEmpty),
+      slots_(buckets_ * kBucketSlots),
+      kick_state_(0x2545f4914f6cdd1dull) {}
+
+/**
+ * @brief Sets the value for the specified key.
+ *
+ * @param key The key to set.
+ * @param value The value associated with the key.
+ * @return true if the record was inserted, false if the key already exists.
+ */
+bool CuckooHashTable::Set(const Key& key, const Value& value) {
+  if (FindSlot(key) != kNotFound) {
+    return false;
+  }
+  InsertSlot(Slot{key, value});
+  return true;
+}
+
+/**
+ * @brief Retrieves the value associated with the specified key.
+ *
+ * @param key The key to retrieve.
+ * @return The value if the key is found, std::nullopt otherwise.
+ */
+std::optional<Value> CuckooHashTable::Get(KeyView key) const {
+  std::size_t index = FindSlot(key);
+  if (index == kNotFound) {
+    return std::nullopt;
+  }
+  return slots_[index].value;
+}
+
+/**
+ * @brief Checks if a record with the given key exists.
+ *
+ * @param key The key to check.
+ * @return true if the key exists, false otherwise.
+ */
+bool CuckooHashTable::Exists(KeyView key) const {
+  return FindSlot(key) != kNotFound;
+}
+
+/**
+ * @brief Deletes the record with the specified key.
+ *
+ * @param key The key to delete.
+ * @return true if the record was deleted, false if the key does not exist.
+ */
+bool CuckooHashTable::Del(KeyView key) {
+  std::size_t index = FindSlot(key);
+  if (index == kNotFound) {
+    return false;
+  }
+  EraseSlot(index);
+  return true;
+}
+
+/**
+ * @brief Updates the value associated with the specified key.
+ *
+ * @param key The key to update.
+ * @param new_value The new value fields, '-' keeps a field unchanged.
+ * @return true if the value was updated, false if the key does not exist.
+ */
+bool CuckooHashTable::Update(const Key& key, const std::string& new_value) {
+  std::size_t index = FindSlot(key);
+  if (index == kNotFound) {
+    return false;
+  }
+  slots_[index].value.Update(new_value);
+  return true;
+}
+
+/**
+ * @brief Retrieves all the keys stored in the table.
+ *
+ * @return A vector containing all the keys.
+ */
+std::vector<Key> CuckooHashTable::Keys() const {
+  std::vector<Key> keys;
+  keys.reserve(size_);
+  ForEach([&keys](const Slot& slot) { keys.push_back(slot.key); });
+  return keys;
+}
+
+/**
+ * @brief Renames a key in the table.
+ *
+ * @param old_key The key to rename.
+ * @param new_key The new name of the key.
+ * @return true if the key was renamed, false if the old key does not exist or
+ * the new key is already taken.
+ */
+bool CuckooHashTable::Rename(const Key& old_key, const Key& new_key) {
+  std::size_t index = FindSlot(old_key);
+  if (index == kNotFound or FindSlot(new_key) != kNotFound) {
+    return false;
+  }
+  Slot slot{new_key, std::move(slots_[index].value)};
+  EraseSlot(index);
+  InsertSlot(std::move(slot));
+  return true;
+}
+
+/**
+ * @brief Retrieves the time-to-live of a key.
+ *
+ * @param key The key to retrieve TTL for.
+ * @return The remaining seconds, or std::nullopt if the key does not exist or
+ * has no TTL.
+ */
+std::optional<std::size_t> CuckooHashTable::TTL(KeyView key) const {
+  std::size_t index = FindSlot(key);
+  if (index == kNotFound) {
+    return std::nullopt;
+  }
+  return slots_[index].value.TTL();
+}
+
+/**
+ * @brief Finds all keys whose value matches the given pattern.
+ *
+ * @param value The value pattern, '-' matches any field.
+ * @return A vector containing the matching keys.
+ */
+std::vector<Key> CuckooHashTable::Find(const std::string& value) const {
+  std::vector<Key> keys;
+  ForEach([&](const Slot& slot) {
+    if (slot.value.Match(value)) {
+      keys.push_back(slot.key);
+    }
+  });
+  return keys;
+}
+
+/**
+ * @brief Retrieves all the values stored in the table.
+ *
+ * @return A vector containing all the values.
+ */
+std::vector<Value> CuckooHashTable::ShowAll() const {
+  std::vector<Value> values;
+  values.reserve(size_);
+  ForEach([&values](const Slot& slot) { values.push_back(slot.value); });
+  return values;
+}
+
+/**
+ * @brief Uploads key-value pairs from a file.
+ *
+ * @param file_path The path to the file containing key-value pairs.
+ * @return The number of records read from the file.
+ */
+std::size_t CuckooHashTable::Upload(const std::string& file_path) {
+  std::ifstream file(file_path);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Invalid file_path");
+  }
+
+  Key key;
+  std::string value;
+
+  std::size_t count = 0u;
+  while (file >> key) {
+    std::getline(file >> std::ws, value);
+    Set(key, Value::FromString(value));
+    ++count;
+  }
+
+  file.close();
+  return count;
+}
+
+/**
+ * @brief Exports key-value pairs to a file.
+ *
+ * @param file_path The path to the file to export key-value pairs to.
+ * @return The number of records written to the file.
+ */
+std::size_t CuckooHashTable::Export(const std::string& file_path) const {
+  std::ofstream file(file_path);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Invalid file_path");
+  }
+
+  std::size_t count = 0u;
+  ForEach([&](const Slot& slot) {
+    file << slot.key << " " << slot.value.ToQuotedString() << "\n";
+    ++count;
+  });
+
+  file.close();
+  return count;
+}
+
+/**
+ * @brief Deletes expired elements from the table.
+ */
+void CuckooHashTable::DeleteExpiredElements() {
+  for (std::size_t i = 0; i < tags_.size(); ++i) {
+    if (tags_[i] != kEmpty and slots_[i].value.TTL() == 0u) {
+      EraseSlot(i);
+    }
+  }
+}
+
+/**
+ * @brief Derives the non-zero slot tag from the low byte of the first hash.
+ *
+ * The bucket index is taken from the high bits of the same hash, so the tag
+ * still tells apart the keys that share a bucket.
+ */
+CuckooHashTable::Tag CuckooHashTable::TagOf(std::uint64_t hash) {
+  Tag tag = static_cast<Tag>(hash);
+  return tag == kEmpty ? 1 : tag;
+}
+
+std::size_t CuckooHashTable::FirstBucket(std::uint64_t hash) const {
+  return FastRange(hash, buckets_);
+}
+
+std::size_t CuckooHashTable::SecondBucket(KeyView key) const {
+  return FastRange(WyHash(key, kSecondSeed), buckets_);
+}
+
+/**
+ * @brief Finds the key among the slots of one bucket.
+ *
+ * @return The slot index, or kNotFound if the bucket does not hold the key.
+ */
+std::size_t CuckooHashTable::FindInBucket(std::size_t bucket, Tag tag,
+                                          KeyView key) const {
+  std::size_t begin = bucket * kBucketSlots;
+  for (std::size_t i = begin; i < begin + kBucketSlots; ++i) {
+    if (tags_[i] == tag and slots_[i].key == key) {
+      return i;
+    }
+  }
+  return kNotFound;
+}
+
+/**
+ * @brief Finds the slot holding the given key.
+ *
+ * Only the two candidate buckets of the key are inspected. The second hash is
+ * computed only if the first bucket does not hold the key.
+ *
+ * @param key The key to look for.
+ * @return The slot index, or kNotFound if the key is absent.
+ */
+std::size_t CuckooHashTable::FindSlot(KeyView key) const {
+  std::uint64_t hash = WyHash(key, kFirstSeed);
+  Tag tag = TagOf(hash);
+  std::size_t index = FindInBucket(FirstBucket(hash), tag, key);
+  if (index != kNotFound) {
+    return index;
+  }
+  return FindInBucket(SecondBucket(key), tag, key);
+}
+
+/**
+ * @brief Finds an empty slot in the bucket.
+ *
+ * @return The slot index, or kNotFound if the bucket is full.
+ */
+std::size_t CuckooHashTable::FreeSlot(std::size_t bucket) const {
+  std::size_t begin = bucket * kBucketSlots;
+  for (std::size_t i = begin; i < begin + kBucketSlots; ++i) {
+    if (tags_[i] == kEmpty) {
+      return i;
+    }
+  }
+  return kNotFound;
+}
+
+/**
+ * @brief Stores a record whose key is not in the table yet.
+ *
+ * If both candidate buckets are full, a randomly chosen resident of one of
+ * them is evicted and reinserted into its own alternative bucket. The walk
+ * continues with the evicted record until a free slot is found. If the walk
+ * takes more than kMaxKicks steps, the table is doubled and the record still
+ * in hand is inserted into the larger table.
+ *
+ * @param slot The record to insert.
+ */
+void CuckooHashTable::InsertSlot(Slot slot) {
+  if (size_ + 1 > kMaxLoadFactor * tags_.size()) {
+    Rehash(buckets_ * 2);
+  }
+  for (std::size_t kick = 0; kick < kMaxKicks; ++kick) {
+    std::uint64_t hash = WyHash(slot.key, kFirstSeed);
+    Tag tag = TagOf(hash);
+    std::size_t buckets[] = {FirstBucket(hash), SecondBucket(slot.key)};
+    for (std::size_t bucket : buckets) {
+      std::size_t index = FreeSlot(bucket);
+      if (index != kNotFound) {
+        tags_[index] = tag;
+        slots_[index] = std::move(slot);
+        ++size_;
+        return;
+      }
+    }
+
+    kick_state_ ^= kick_state_ << 13;
+    kick_state_ ^= kick_state_ >> 7;
+    kick_state_ ^= kick_state_ << 17;
+    std::size_t victim = buckets[kick_state_ & 1] * kBucketSlots +
+                         (kick_state_ >> 1) % kBucketSlots;
+    std::swap(slot, slots_[victim]);
+    tags_[victim] = tag;
+  }
+  Rehash(buckets_ * 2);
+  InsertSlot(std::move(slot));
+}
+
+/**
+ * @brief Removes the record stored in the given slot.
+ *
+ * A cuckoo lookup never probes past a bucket, so the slot simply becomes
+ * empty and no tombstone is needed.
+ *
+ * @param index The index of a full slot.
+ */
+void CuckooHashTable::EraseSlot(std::size_t index) {
+  tags_[index] = kEmpty;
+  slots_[index] = Slot();
+  --size_;
+}
+
+/**
+ * @brief Moves all the records into freshly allocated arrays.
+ *
+ * @param new_buckets The number of buckets of the new arrays.
+ */
+void CuckooHashTable::Rehash(std::size_t new_buckets) {
+  std::vector<Tag> old_tags = std::move(tags_);
+  std::vector<Slot> old_slots = std::move(slots_);
+
+  buckets_ = new_buckets;
+  size_ = 0;
+  tags_.assign(buckets_ * kBucketSlots, kEmpty);
+  slots_.clear();
+  slots_.resize(buckets_ * kBucketSlots);
+
+  for (std::size_t i = 0; i < old_tags.size(); ++i) {
+    if (old_tags[i] != kEmpty) {
+      InsertSlot(std::move(old_slots[i]));
+    }
+  }
+}
+
+void CuckooHashTable::ForEach(
+    const std::function<void(const Slot&)>& func) const {
+  for (std::size_t i = 0; i < tags_.size(); ++i) {
+    if (tags_[i] != kEmpty) {
+      func(slots_[i]);
+    }
+  }
+}
+
+}  // namespace s21
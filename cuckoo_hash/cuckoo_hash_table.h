@@ -0,0 +1,86 @@
+#ifndef TRANSACTIONS_CUCKOO_HASH_CUCKOO_HASH_TABLE_H_
+#define TRANSACTIONS_CUCKOO_HASH_CUCKOO_HASH_TABLE_H_
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+
+#include "../common/abstract_store.h"
+
+namespace s21 {
+
+/**
+ * @brief In-memory key-value store based on bucketized cuckoo hashing.
+ *
+ * Slots are grouped into buckets of kBucketSlots and every key may live in
+ * only two buckets, chosen by two independently seeded hashes. A lookup
+ * therefore probes at most two buckets, no matter how full the table is. Each
+ * slot has a one-byte tag derived from the first hash, so most non-matching
+ * slots are rejected without touching the key string, and the second hash is
+ * computed only when the first bucket misses.
+ *
+ * When both buckets of a new key are full, a resident of one of them is
+ * evicted to its alternative bucket, possibly evicting another key in turn.
+ * With four slots per bucket such eviction chains stay short up to well above
+ * 90% occupancy, so the table grows only at kMaxLoadFactor or when a chain
+ * exceeds kMaxKicks. Records are stored inline, with no per-key allocation.
+ */
+class CuckooHashTable : public AbstractStore {
+ public:
+  explicit CuckooHashTable(std::size_t capacity = kMinCapacity);
+
+  bool Set(const Key& key, const Value& value) override;
+  std::optional<Value> Get(KeyView key) const override;
+  bool Exists(KeyView key) const override;
+  bool Del(KeyView key) override;
+  bool Update(const Key& key, const std::string& new_value) override;
+  std::vector<Key> Keys() const override;
+  bool Rename(const Key& old_key, const Key& new_key) override;
+  std::optional<std::size_t> TTL(KeyView key) const override;
+  std::vector<Key> Find(const std::string& value) const override;
+  std::vector<Value> ShowAll() const override;
+  std::size_t Upload(const std::string& file_path) override;
+  std::size_t Export(const std::string& file_path) const override;
+  void DeleteExpiredElements() override;
+
+  std::size_t Size() const { return size_; }
+  std::size_t Capacity() const { return tags_.size(); }
+
+ private:
+  using Tag = std::uint8_t;
+
+  struct Slot {
+    Key key;
+    Value value;
+  };
+
+  static constexpr std::size_t kBucketSlots = 4;
+  static constexpr std::size_t kMinCapacity = 256;
+  static constexpr float kMaxLoadFactor = 0.95;
+  static constexpr std::size_t kMaxKicks = 500;
+  static constexpr std::uint64_t kFirstSeed = 0x9e3779b97f4a7c15ull;
+  static constexpr std::uint64_t kSecondSeed = 0xc2b2ae3d27d4eb4full;
+  static constexpr Tag kEmpty = 0;
+  static constexpr std::size_t kNotFound = static_cast<std::size_t>(-1);
+
+  std::size_t buckets_;
+  std::size_t size_;
+  std::vector<Tag> tags_;
+  std::vector<Slot> slots_;
+  std::uint64_t kick_state_;
+
+  static Tag TagOf(std::uint64_t hash);
+  std::size_t FirstBucket(std::uint64_t hash) const;
+  std::size_t SecondBucket(KeyView key) const;
+  std::size_t FindInBucket(std::size_t bucket, Tag tag, KeyView key) const;
+  std::size_t FindSlot(KeyView key) const;
+  std::size_t FreeSlot(std::size_t bucket) const;
+  void InsertSlot(Slot slot);
+  void EraseSlot(std::size_t index);
+  void Rehash(std::size_t new_buckets);
+  void ForEach(const std::function<void(const Slot&)>& func) const;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_CUCKOO_HASH_CUCKOO_HASH_TABLE_H_
@@ -0,0 +1,268 @@
+#include "concurrent_hash_table.h"
+
+namespace s21 {
+
+ConcurrentHashTable::ConcurrentHashTable(std::size_t capacity)
+    : capacity_(kTableCapacity), size_(0) {
+  while (capacity_ < capacity) capacity_ *= 2;
+  table_.resize(capacity_);
+}
+
+bool ConcurrentHashTable::Set(const Key& key, const Value& value) {
+  std::size_t hash = HashFunction(key);
+  std::size_t seen_capacity;
+  {
+    UniqueLock lock(StripeOf(hash));
+    if (FindNode(key, hash) != nullptr) {
+      return false;
+    }
+    Link(std::make_unique<Node>(key, value), hash);
+    seen_capacity = capacity_;
+  }
+  if (static_cast<float>(++size_) / seen_capacity > kMaxLoadFactor) {
+    Grow(seen_capacity);
+  }
+  return true;
+}
+
+std::optional<Value> ConcurrentHashTable::Get(KeyView key) const {
+  std::size_t hash = HashFunction(key);
+  SharedLock lock(StripeOf(hash));
+  const Node* node = FindNode(key, hash);
+  if (node != nullptr) {
+    return node->value;
+  }
+  return std::nullopt;
+}
+
+bool ConcurrentHashTable::Exists(KeyView key) const {
+  std::size_t hash = HashFunction(key);
+  SharedLock lock(StripeOf(hash));
+  return FindNode(key, hash) != nullptr;
+}
+
+bool ConcurrentHashTable::Del(KeyView key) {
+  std::size_t hash = HashFunction(key);
+  UniqueLock lock(StripeOf(hash));
+  if (Unlink(key, hash) == nullptr) {
+    return false;
+  }
+  --size_;
+  return true;
+}
+
+bool ConcurrentHashTable::Update(const Key& key, const std::string& new_value) {
+  std::size_t hash = HashFunction(key);
+  UniqueLock lock(StripeOf(hash));
+  Node* node = FindNode(key, hash);
+  if (node == nullptr) {
+    return false;
+  }
+  node->value.Update(new_value);
+  return true;
+}
+
+std::vector<Key> ConcurrentHashTable::Keys() const {
+  std::vector<Key> keys;
+  ForEachNode([&keys](const Node& node) { keys.push_back(node.key); });
+  return keys;
+}
+
+bool ConcurrentHashTable::Rename(const Key& old_key, const Key& new_key) {
+  std::size_t old_hash = HashFunction(old_key);
+  std::size_t new_hash = HashFunction(new_key);
+
+  // Both stripes are taken in index order, the same order LockAllShared and
+  // Grow use, so two renames in opposite directions cannot deadlock.
+  std::size_t first = std::min(old_hash % kStripes, new_hash % kStripes);
+  std::size_t second = std::max(old_hash % kStripes, new_hash % kStripes);
+  UniqueLock first_lock(stripes_[first].mutex);
+  UniqueLock second_lock;
+  if (second != first) {
+    second_lock = UniqueLock(stripes_[second].mutex);
+  }
+
+  if (FindNode(old_key, old_hash) == nullptr or
+      FindNode(new_key, new_hash) != nullptr) {
+    return false;
+  }
+  std::unique_ptr<Node> node = Unlink(old_key, old_hash);
+  node->key = new_key;
+  Link(std::move(node), new_hash);
+  return true;
+}
+
+std::optional<std::size_t> ConcurrentHashTable::TTL(KeyView key) const {
+  std::size_t hash = HashFunction(key);
+  SharedLock lock(StripeOf(hash));
+  const Node* node = FindNode(key, hash);
+  if (node != nullptr) {
+    return node->value.TTL();
+  }
+  return std::nullopt;
+}
+
+std::vector<Key> ConcurrentHashTable::Find(const std::string& value) const {
+  std::vector<Key> keys;
+  ForEachNode([&](const Node& node) {
+    if (node.value.Match(value)) {
+      keys.push_back(node.key);
+    }
+  });
+  return keys;
+}
+
+std::vector<Value> ConcurrentHashTable::ShowAll() const {
+  std::vector<Value> values;
+  ForEachNode([&values](const Node& node) { values.push_back(node.value); });
+  return values;
+}
+
+std::size_t ConcurrentHashTable::Upload(const std::string& file_path) {
+  std::ifstream file(file_path);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Invalid file_path");
+  }
+
+  Key key;
+  std::string value;
+
+  std::size_t count = 0u;
+  while (file >> key) {
+    std::getline(file >> std::ws, value);
+    Set(key, Value::FromString(value));
+    ++count;
+  }
+
+  file.close();
+  return count;
+}
+
+std::size_t ConcurrentHashTable::Export(const std::string& file_path) const {
+  std::ofstream file(file_path);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Invalid file_path");
+  }
+
+  std::size_t count = 0u;
+  ForEachNode([&](const Node& node) {
+    file << node.key << " " << node.value.ToQuotedString() << "\n";
+    ++count;
+  });
+
+  file.close();
+  return count;
+}
+
+void ConcurrentHashTable::DeleteExpiredElements() {
+  // Stripes are swept one at a time, so readers and writers of the other
+  // stripes are never blocked by the sweep.
+  for (std::size_t stripe = 0; stripe < kStripes; ++stripe) {
+    UniqueLock lock(stripes_[stripe].mutex);
+    for (std::size_t i = stripe; i < capacity_; i += kStripes) {
+      std::unique_ptr<Node>* link = &table_[i];
+      while (*link != nullptr) {
+        if ((*link)->value.TTL() == 0u) {
+          *link = std::move((*link)->next);
+          --size_;
+        } else {
+          link = &(*link)->next;
+        }
+      }
+    }
+  }
+}
+
+std::size_t ConcurrentHashTable::Size() const { return size_; }
+
+std::size_t ConcurrentHashTable::HashFunction(KeyView key) {
+  return std::hash<KeyView>{}(key);
+}
+
+std::shared_mutex& ConcurrentHashTable::StripeOf(std::size_t hash) const {
+  return stripes_[hash % kStripes].mutex;
+}
+
+std::unique_ptr<ConcurrentHashTable::Node>& ConcurrentHashTable::BucketOf(
+    std::size_t hash) {
+  return table_[hash % capacity_];
+}
+
+ConcurrentHashTable::Node* ConcurrentHashTable::FindNode(
+    KeyView key, std::size_t hash) const {
+  for (Node* node = table_[hash % capacity_].get(); node != nullptr;
+       node = node->next.get()) {
+    if (node->key == key) {
+      return node;
+    }
+  }
+  return nullptr;
+}
+
+std::unique_ptr<ConcurrentHashTable::Node> ConcurrentHashTable::Unlink(
+    KeyView key, std::size_t hash) {
+  std::unique_ptr<Node>* link = &BucketOf(hash);
+  while (*link != nullptr) {
+    if ((*link)->key == key) {
+      std::unique_ptr<Node> node = std::move(*link);
+      *link = std::move(node->next);
+      return node;
+    }
+    link = &(*link)->next;
+  }
+  return nullptr;
+}
+
+void ConcurrentHashTable::Link(std::unique_ptr<Node> node, std::size_t hash) {
+  std::unique_ptr<Node>& bucket = BucketOf(hash);
+  node->next = std::move(bucket);
+  bucket = std::move(node);
+}
+
+void ConcurrentHashTable::Grow(std::size_t seen_capacity) {
+  std::vector<UniqueLock> locks;
+  locks.reserve(kStripes);
+  for (Stripe& stripe : stripes_) {
+    locks.emplace_back(stripe.mutex);
+  }
+  // Another writer may have grown the table while this one waited.
+  if (capacity_ != seen_capacity) return;
+
+  std::size_t new_capacity = capacity_ * 2;
+  std::vector<std::unique_ptr<Node>> new_table(new_capacity);
+  for (std::unique_ptr<Node>& bucket : table_) {
+    while (bucket != nullptr) {
+      std::unique_ptr<Node> node = std::move(bucket);
+      bucket = std::move(node->next);
+      std::unique_ptr<Node>& new_bucket =
+          new_table[HashFunction(node->key) % new_capacity];
+      node->next = std::move(new_bucket);
+      new_bucket = std::move(node);
+    }
+  }
+  table_ = std::move(new_table);
+  capacity_ = new_capacity;
+}
+
+std::vector<ConcurrentHashTable::SharedLock>
+ConcurrentHashTable::LockAllShared() const {
+  std::vector<SharedLock> locks;
+  locks.reserve(kStripes);
+  for (const Stripe& stripe : stripes_) {
+    locks.emplace_back(stripe.mutex);
+  }
+  return locks;
+}
+
+void ConcurrentHashTable::ForEachNode(
+    const std::function<void(const Node&)>& func) const {
+  std::vector<SharedLock> locks = LockAllShared();
+  for (const std::unique_ptr<Node>& bucket : table_) {
+    for (const Node* node = bucket.get(); node != nullptr;
+         node = node->next.get()) {
+      func(*node);
+    }
+  }
+}
+
+}  // namespace s21
@@ -0,0 +1,84 @@
+#ifndef TRANSACTIONS_HASH_TABLE_CONCURRENT_HASH_TABLE_H_
+#define TRANSACTIONS_HASH_TABLE_CONCURRENT_HASH_TABLE_H_
+
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+#include "../common/abstract_store.h"
+
+namespace s21 {
+
+/**
+ * @brief Thread-safe key-value store based on a lock-striped hash table.
+ *
+ * Buckets are protected by a fixed set of reader-writer locks: the bucket of a
+ * key is guarded by stripe hash % kStripes. Because the capacity is always a
+ * multiple of kStripes, a key keeps its stripe across resizes. Readers
+ * (Get, Exists, TTL) take their stripe in shared mode and run in parallel with
+ * each other and with writers of other stripes. Resizing and full scans take
+ * every stripe, always in the same order, so they cannot deadlock.
+ */
+class ConcurrentHashTable : public AbstractStore {
+ public:
+  explicit ConcurrentHashTable(std::size_t capacity = kTableCapacity);
+
+  bool Set(const Key& key, const Value& value) override;
+  std::optional<Value> Get(KeyView key) const override;
+  bool Exists(KeyView key) const override;
+  bool Del(KeyView key) override;
+  bool Update(const Key& key, const std::string& new_value) override;
+  std::vector<Key> Keys() const override;
+  bool Rename(const Key& old_key, const Key& new_key) override;
+  std::optional<std::size_t> TTL(KeyView key) const override;
+  std::vector<Key> Find(const std::string& value) const override;
+  std::vector<Value> ShowAll() const override;
+  std::size_t Upload(const std::string& file_path) override;
+  std::size_t Export(const std::string& file_path) const override;
+  void DeleteExpiredElements() override;
+
+  std::size_t Size() const;
+
+ private:
+  struct Node {
+    Key key;
+    Value value;
+    std::unique_ptr<Node> next;
+
+    Node(const Key& k, const Value& v) : key(k), value(v), next(nullptr) {}
+  };
+
+  struct alignas(64) Stripe {
+    mutable std::shared_mutex mutex;
+  };
+
+  using SharedLock = std::shared_lock<std::shared_mutex>;
+  using UniqueLock = std::unique_lock<std::shared_mutex>;
+
+  static constexpr std::size_t kStripes = 64;
+  static constexpr std::size_t kTableCapacity = 256;
+  static constexpr float kMaxLoadFactor = 0.75;
+
+  std::array<Stripe, kStripes> stripes_;
+  std::vector<std::unique_ptr<Node>> table_;
+  std::size_t capacity_;
+  std::atomic<std::size_t> size_;
+
+  static std::size_t HashFunction(KeyView key);
+  std::shared_mutex& StripeOf(std::size_t hash) const;
+  std::unique_ptr<Node>& BucketOf(std::size_t hash);
+  Node* FindNode(KeyView key, std::size_t hash) const;
+  std::unique_ptr<Node> Unlink(KeyView key, std::size_t hash);
+  void Link(std::unique_ptr<Node> node, std::size_t hash);
+  void Grow(std::size_t seen_capacity);
+  std::vector<SharedLock> LockAllShared() const;
+  void ForEachNode(const std::function<void(const Node&)>& func) const;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_HASH_TABLE_CONCURRENT_HASH_TABLE_H_
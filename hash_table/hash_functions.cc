@@ -0,0 +1,154 @@
+#include "hash_functions.h"
+
+#include <cstring>
+#include <functional>
+
+namespace s21 {
+
+namespace {
+
+__extension__ using UInt128 = unsigned __int128;
+
+constexpr std::uint64_t kWySecret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull,
+    0x4d5a2da51de1aa47ull};
+
+void WyMultiply(std::uint64_t& a, std::uint64_t& b) {
+  UInt128 product = static_cast<UInt128>(a) * b;
+  a = static_cast<std::uint64_t>(product);
+  b = static_cast<std::uint64_t>(product >> 64);
+}
+
+std::uint64_t WyMix(std::uint64_t a, std::uint64_t b) {
+  WyMultiply(a, b);
+  return a ^ b;
+}
+
+std::uint64_t Read8(const unsigned char* p) {
+  std::uint64_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+std::uint64_t Read4(const unsigned char* p) {
+  std::uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+std::uint64_t Read3(const unsigned char* p, std::size_t len) {
+  return (static_cast<std::uint64_t>(p[0]) << 16) |
+         (static_cast<std::uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+}
+
+}  // namespace
+
+/**
+ * @brief Hashes the key with the standard library hash.
+ *
+ * Its speed and quality depend on the library implementation.
+ */
+std::uint64_t StdHash(std::string_view key) {
+  return std::hash<std::string_view>{}(key);
+}
+
+/**
+ * @brief Hashes the key with 64-bit FNV-1a.
+ *
+ * Simple and portable, but processes one byte per multiplication.
+ */
+std::uint64_t Fnv1aHash(std::string_view key) {
+  std::uint64_t hash = 0xcbf29ce484222325ull;
+  for (unsigned char c : key) {
+    hash ^= c;
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+/**
+ * @brief Hashes the key with wyhash using a zero seed.
+ */
+std::uint64_t WyHash(std::string_view key) { return WyHash(key, 0); }
+
+/**
+ * @brief Hashes the key with wyhash.
+ *
+ * wyhash consumes 16 bytes per 64x64->128 bit multiplication and passes
+ * SMHasher, which makes it one of the fastest high-quality hashes for short
+ * and medium keys.
+ *
+ * @param key The key to hash.
+ * @param seed The seed that selects an independent hash function.
+ * @return The 64-bit hash of the key.
+ */
+std::uint64_t WyHash(std::string_view key, std::uint64_t seed) {
+  const auto* p = reinterpret_cast<const unsigned char*>(key.data());
+  std::size_t len = key.size();
+  seed ^= WyMix(seed ^ kWySecret[0], kWySecret[1]);
+
+  std::uint64_t a = 0;
+  std::uint64_t b = 0;
+  if (len <= 16) {
+    if (len >= 4) {
+      a = (Read4(p) << 32) | Read4(p + ((len >> 3) << 2));
+      b = (Read4(p + len - 4) << 32) | Read4(p + len - 4 - ((len >> 3) << 2));
+    } else if (len > 0) {
+      a = Read3(p, len);
+    }
+  } else {
+    std::size_t i = len;
+    if (i > 48) {
+      std::uint64_t see1 = seed;
+      std::uint64_t see2 = seed;
+      do {
+        seed = WyMix(Read8(p) ^ kWySecret[1], Read8(p + 8) ^ seed);
+        see1 = WyMix(Read8(p + 16) ^ kWySecret[2], Read8(p + 24) ^ see1);
+        see2 = WyMix(Read8(p + 32) ^ kWySecret[3], Read8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = WyMix(Read8(p) ^ kWySecret[1], Read8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = Read8(p + i - 16);
+    b = Read8(p + i - 8);
+  }
+
+  a ^= kWySecret[1];
+  b ^= seed;
+  WyMultiply(a, b);
+  return WyMix(a ^ kWySecret[0] ^ len, b ^ kWySecret[1]);
+}
+
+/**
+ * @brief Maps a hash uniformly onto [0, range) without a division.
+ *
+ * The result is the upper half of the 128-bit product hash * range, which is
+ * monotonic in the hash. It relies on the high bits of the hash being well
+ * mixed.
+ */
+std::uint64_t FastRange(std::uint64_t hash, std::uint64_t range) {
+  return static_cast<std::uint64_t>((static_cast<UInt128>(hash) * range) >>
+                                    64);
+}
+
+/**
+ * @brief Returns the smallest hash that FastRange maps onto index.
+ *
+ * Because FastRange is monotonic, the hashes mapped onto index form the
+ * interval [FastRangeStart(index), FastRangeStart(index + 1)).
+ *
+ * @param index A value in [0, range).
+ * @param range The size of the target interval.
+ */
+std::uint64_t FastRangeStart(std::uint64_t index, std::uint64_t range) {
+  return static_cast<std::uint64_t>(
+      ((static_cast<UInt128>(index) << 64) + range - 1) / range);
+}
+
+}  // namespace s21
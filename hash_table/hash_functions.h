@@ -0,0 +1,33 @@
+#ifndef TRANSACTIONS_HASH_TABLE_HASH_FUNCTIONS_H_
+#define TRANSACTIONS_HASH_TABLE_HASH_FUNCTIONS_H_
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace s21 {
+
+/**
+ * @brief Strategy that maps a key to a 64-bit hash.
+ */
+using Hasher = std::uint64_t (*)(std::string_view key);
+
+std::uint64_t StdHash(std::string_view key);
+std::uint64_t Fnv1aHash(std::string_view key);
+std::uint64_t WyHash(std::string_view key);
+std::uint64_t WyHash(std::string_view key, std::uint64_t seed);
+
+std::uint64_t FastRange(std::uint64_t hash, std::uint64_t range);
+std::uint64_t FastRangeStart(std::uint64_t index, std::uint64_t range);
+
+struct NamedHasher {
+  const char* name;
+  Hasher hasher;
+};
+
+inline const std::array<NamedHasher, 3> kHashers = {
+    {{"std::hash", StdHash}, {"FNV-1a", Fnv1aHash}, {"wyhash", WyHash}}};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_HASH_TABLE_HASH_FUNCTIONS_H_
@@ -2,46 +2,74 @@
 
 namespace s21 {
 
-HashTable::HashTable(std::size_t capacity)
-    : capacity_(capacity), size_(0), table_(capacity, nullptr) {
-  if (capacity_ < kTableCapacity) {
-    capacity_ = kTableCapacity;
+namespace {
+
+void Prefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address);
+#else
+  (void)address;
+#endif
+}
+
+}  // namespace
+
+HashTable::HashTable(std::size_t capacity, Hasher hasher)
+    : capacity_(capacity),
+      size_(0),
+      table_(capacity, nullptr),
+      rehash_index_(0),
+      hasher_(hasher) {
+  if (capacity_ < kDefaultCapacity) {
+    capacity_ = kDefaultCapacity;
     table_.resize(capacity_, nullptr);
   }
 }
 
+HashTable::~HashTable() {
+  for (auto* table : {&old_table_, &table_}) {
+    for (Node* node : *table) {
+      while (node != nullptr) {
+        pool_.Destroy(std::exchange(node, node->next));
+      }
+    }
+  }
+}
+
 bool HashTable::Set(const Key& key, const Value& value) {
-  std::shared_ptr<Node> node = FindNode(key);
+  std::size_t hash = HashFunction(key);
+  Node* node = FindNode(key, hash);
   if (node != nullptr) {
     return false;
   }
-  InsertNode(key, value);
+  InsertNode(key, value, hash);
   return true;
 }
 
-std::optional<Value> HashTable::Get(const Key& key) const {
-  std::shared_ptr<Node> node = FindNode(key);
+std::optional<Value> HashTable::Get(KeyView key) const {
+  Node* node = FindNode(key);
   if (node != nullptr) {
     return node->value;
   }
   return std::nullopt;
 }
 
-bool HashTable::Exists(const Key& key) const {
+bool HashTable::Exists(KeyView key) const {
   return FindNode(key) != nullptr;
 }
 
-bool HashTable::Del(const Key& key) {
-  std::shared_ptr<Node> node = FindNode(key);
+bool HashTable::Del(KeyView key) {
+  std::size_t hash = HashFunction(key);
+  Node* node = FindNode(key, hash);
   if (node == nullptr) {
     return false;
   }
-  DeleteNode(key);
+  DeleteNode(key, hash);
   return true;
 }
 
 bool HashTable::Update(const Key& key, const std::string& new_value) {
-  std::shared_ptr<Node> node = FindNode(key);
+  Node* node = FindNode(key);
   if (node != nullptr) {
     node->value.Update(new_value);
     return true;
@@ -51,28 +79,25 @@ bool HashTable::Update(const Key& key, const std::string& new_value) {
 
 std::vector<Key> HashTable::Keys() const {
   std::vector<Key> keys;
-  for (const auto& node : table_) {
-    std::shared_ptr<Node> current = node;
-    while (current != nullptr) {
-      keys.push_back(current->key);
-      current = current->next;
-    }
-  }
+  ForEachNode([&keys](const Node& node) { keys.push_back(node.key); });
   return keys;
 }
 
 bool HashTable::Rename(const Key& old_key, const Key& new_key) {
-  if (!Exists(old_key) or Exists(new_key)) {
+  std::size_t old_hash = HashFunction(old_key);
+  std::size_t new_hash = HashFunction(new_key);
+  Node* node = FindNode(old_key, old_hash);
+  if (node == nullptr or FindNode(new_key, new_hash) != nullptr) {
     return false;
   }
-  std::shared_ptr<Node> node = FindNode(old_key);
-  DeleteNode(old_key);
-  InsertNode(new_key, node->value);
+  Value value = std::move(node->value);
+  DeleteNode(old_key, old_hash);
+  InsertNode(new_key, value, new_hash);
   return true;
 }
 
-std::optional<std::size_t> HashTable::TTL(const Key& key) const {
-  std::shared_ptr<Node> node = FindNode(key);
+std::optional<std::size_t> HashTable::TTL(KeyView key) const {
+  Node* node = FindNode(key);
   if (node != nullptr) {
     return node->value.TTL();
   }
@@ -81,27 +106,17 @@ std::optional<std::size_t> HashTable::TTL(const Key& key) const {
 
 std::vector<Key> HashTable::Find(const std::string& value) const {
   std::vector<Key> keys;
-  for (const auto& node : table_) {
-    std::shared_ptr<Node> current = node;
-    while (current != nullptr) {
-      if (current->value.Match(value)) {
-        keys.push_back(current->key);
-      }
-      current = current->next;
+  ForEachNode([&](const Node& node) {
+    if (node.value.Match(value)) {
+      keys.push_back(node.key);
     }
-  }
+  });
   return keys;
 }
 
 std::vector<Value> HashTable::ShowAll() const {
   std::vector<Value> values;
-  for (const auto& node : table_) {
-    std::shared_ptr<Node> current = node;
-    while (current != nullptr) {
-      values.push_back(current->value);
-      current = current->next;
-    }
-  }
+  ForEachNode([&values](const Node& node) { values.push_back(node.value); });
   return values;
 }
 
@@ -132,14 +147,10 @@ std::size_t HashTable::Export(const std::string& file_path) const {
   }
 
   std::size_t count = 0u;
-  for (const auto& node : table_) {
-    std::shared_ptr<Node> current = node;
-    while (current != nullptr) {
-      file << current->key << " " << current->value.ToQuotedString() << "\n";
-      ++count;
-      current = current->next;
-    }
-  }
+  ForEachNode([&](const Node& node) {
+    file << node.key << " " << node.value.ToQuotedString() << "\n";
+    ++count;
+  });
 
   file.close();
   return count;
@@ -148,23 +159,146 @@ std::size_t HashTable::Export(const std::string& file_path) const {
 void HashTable::DeleteExpiredElements() {
   std::vector<Key> keys = Keys();
   std::vector<Value> values = ShowAll();
+  std::size_t deleted = 0;
   for (auto i = 0u; i < keys.size(); ++i) {
     if (values[i].TTL() == 0u) {
       Del(keys[i]);
+      ++deleted;
+    }
+  }
+  // An expiry wave that wiped out most of the records leaves the node slabs
+  // mostly empty, so give that memory back right away.
+  if (deleted > 0 and deleted >= size_) {
+    Compact();
+  }
+}
+
+std::vector<std::optional<Value>> HashTable::MGet(
+    const std::vector<Key>& keys) const {
+  std::vector<std::size_t> hashes(keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    hashes[i] = HashFunction(keys[i]);
+    PrefetchBucket(hashes[i]);
+  }
+
+  std::vector<std::optional<Value>> values(keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    if (i + kPrefetchDistance < keys.size()) {
+      PrefetchChain(hashes[i + kPrefetchDistance]);
+    }
+    Node* node = FindNode(keys[i], hashes[i]);
+    if (node != nullptr) {
+      values[i] = node->value;
     }
   }
+  return values;
 }
 
-std::size_t HashTable::HashFunction(const Key& key) const {
-  std::hash<Key> hash_func;
-  return hash_func(key) % capacity_;
+AbstractStore::ScanResult HashTable::Scan(const std::string& cursor,
+                                          std::size_t count) const {
+  if (count == 0) count = 1;
+  std::uint64_t position = cursor.empty() ? 0 : ParseCursor(cursor);
+  std::size_t index = BucketIndex(position, capacity_);
+  // Like the rehash steps, a call gives up after a bounded number of buckets
+  // even if they were all empty.
+  std::size_t visits = count * kScanEmptyVisits;
+
+  ScanResult result;
+  while (index < capacity_ and result.keys.size() < count and visits-- > 0) {
+    ++index;
+    std::uint64_t end = index < capacity_ ? FastRangeStart(index, capacity_)
+                                          : ~std::uint64_t{0};
+    std::uint64_t last = index < capacity_ ? end - 1 : end;
+    if (IsRehashing()) {
+      CollectRange(old_table_, position, last, result.keys);
+    }
+    CollectRange(table_, position, last, result.keys);
+    position = end;
+  }
+  if (index < capacity_) {
+    result.cursor = std::to_string(position);
+  }
+  return result;
 }
 
-std::shared_ptr<HashTable::Node> HashTable::FindNode(const Key& key) const {
-  std::size_t index = HashFunction(key);
-  std::shared_ptr<Node> current = table_[index];
+void HashTable::Compact() {
+  FinishRehash();
+
+  std::size_t new_capacity = kDefaultCapacity;
+  while (static_cast<float>(size_) / new_capacity > kMaxLoadFactor / 2) {
+    new_capacity *= 2;
+  }
+
+  ObjectPool<Node> new_pool;
+  std::vector<Node*> new_table(new_capacity, nullptr);
+  for (Node*& bucket : table_) {
+    for (Node* node = std::exchange(bucket, nullptr); node != nullptr;) {
+      Node* new_node = new_pool.Create(std::move(node->key),
+                                       std::move(node->value), node->hash);
+      Node*& new_bucket = new_table[BucketIndex(new_node->hash, new_capacity)];
+      new_node->next = new_bucket;
+      new_bucket = new_node;
+      pool_.Destroy(std::exchange(node, node->next));
+    }
+  }
+
+  capacity_ = new_capacity;
+  table_ = std::move(new_table);
+  pool_ = std::move(new_pool);
+}
+
+std::size_t HashTable::Size() const { return size_; }
+
+std::size_t HashTable::Capacity() const { return capacity_; }
+
+bool HashTable::IsRehashing() const { return !old_table_.empty(); }
+
+std::vector<std::size_t> HashTable::ChainLengths() const {
+  std::vector<std::size_t> histogram(1, 0);
+  auto count = [&histogram](const Node* node) {
+    std::size_t length = 0;
+    for (; node != nullptr; node = node->next) ++length;
+    if (length >= histogram.size()) histogram.resize(length + 1, 0);
+    ++histogram[length];
+  };
+  for (std::size_t i = rehash_index_; i < old_table_.size(); ++i) {
+    count(old_table_[i]);
+  }
+  for (const Node* bucket : table_) {
+    count(bucket);
+  }
+  return histogram;
+}
+
+std::size_t HashTable::HashFunction(KeyView key) const {
+  return hasher_(key);
+}
+
+std::size_t HashTable::BucketIndex(std::size_t hash,
+                                   std::size_t capacity) const {
+  return FastRange(hash, capacity);
+}
+
+HashTable::Node* HashTable::FindNode(KeyView key) const {
+  return FindNode(key, HashFunction(key));
+}
+
+HashTable::Node* HashTable::FindNode(KeyView key, std::size_t hash) const {
+  if (IsRehashing()) {
+    std::size_t old_index = BucketIndex(hash, old_table_.size());
+    if (old_index >= rehash_index_) {
+      for (Node* current = old_table_[old_index]; current != nullptr;
+           current = current->next) {
+        if (current->hash == hash and current->key == key) {
+          return current;
+        }
+      }
+    }
+  }
+  std::size_t index = BucketIndex(hash, capacity_);
+  Node* current = table_[index];
   while (current != nullptr) {
-    if (current->key == key) {
+    if (current->hash == hash and current->key == key) {
       return current;
     }
     current = current->next;
@@ -172,17 +306,33 @@ std::shared_ptr<HashTable::Node> HashTable::FindNode(const Key& key) const {
   return nullptr;
 }
 
-void HashTable::InsertNode(const Key& key, const Value& value) {
+void HashTable::PrefetchBucket(std::size_t hash) const {
+  if (IsRehashing()) {
+    Prefetch(&old_table_[BucketIndex(hash, old_table_.size())]);
+  }
+  Prefetch(&table_[BucketIndex(hash, capacity_)]);
+}
+
+void HashTable::PrefetchChain(std::size_t hash) const {
+  if (IsRehashing()) {
+    Prefetch(old_table_[BucketIndex(hash, old_table_.size())]);
+  }
+  Prefetch(table_[BucketIndex(hash, capacity_)]);
+}
+
+void HashTable::InsertNode(const Key& key, const Value& value,
+                           std::size_t hash) {
+  RehashStep(kRehashStep);
   if (static_cast<float>(size_ + 1) / capacity_ > kMaxLoadFactor) {
     Resize(capacity_ * 2);
   }
-  std::size_t index = HashFunction(key);
-  std::shared_ptr<Node> new_node = std::make_shared<Node>(key, value);
+  std::size_t index = BucketIndex(hash, capacity_);
+  Node* new_node = pool_.Create(key, value, hash);
 
   if (table_[index] == nullptr) {
     table_[index] = new_node;
   } else {
-    std::shared_ptr<Node> last_node = table_[index];
+    Node* last_node = table_[index];
     while (last_node->next != nullptr) {
       last_node = last_node->next;
     }
@@ -192,44 +342,110 @@ void HashTable::InsertNode(const Key& key, const Value& value) {
   ++size_;
 }
 
-void HashTable::DeleteNode(const Key& key) {
-  std::size_t index = HashFunction(key);
-  std::shared_ptr<Node> node = table_[index];
-  std::shared_ptr<Node> prev_node = nullptr;
-
-  while (node != nullptr) {
-    if (node->key == key) {
-      if (prev_node != nullptr) {
-        prev_node->next = node->next;
-      } else {
-        table_[index] = node->next;
+void HashTable::DeleteNode(KeyView key, std::size_t hash) {
+  auto unlink = [this, &key, hash](Node*& bucket) {
+    Node* node = bucket;
+    Node* prev_node = nullptr;
+    while (node != nullptr) {
+      if (node->hash == hash and node->key == key) {
+        if (prev_node != nullptr) {
+          prev_node->next = node->next;
+        } else {
+          bucket = node->next;
+        }
+        pool_.Destroy(node);
+        return true;
       }
-      break;
+      prev_node = node;
+      node = node->next;
     }
-    prev_node = node;
-    node = node->next;
+    return false;
+  };
+
+  bool unlinked = false;
+  if (IsRehashing()) {
+    std::size_t old_index = BucketIndex(hash, old_table_.size());
+    if (old_index >= rehash_index_) {
+      unlinked = unlink(old_table_[old_index]);
+    }
+  }
+  if (!unlinked) {
+    unlink(table_[BucketIndex(hash, capacity_)]);
   }
   --size_;
+  RehashStep(kRehashStep);
+  if (!IsRehashing() and
+      static_cast<float>(size_) / capacity_ < kMinLoadFactor) {
+    Resize(capacity_ / 2);
+  }
 }
 
 void HashTable::Resize(std::size_t new_size) {
-  if (new_size < kTableCapacity) new_size = kTableCapacity;
+  if (new_size < kDefaultCapacity) new_size = kDefaultCapacity;
   if (new_size == capacity_) return;
 
-  std::vector<std::shared_ptr<Node>> new_table(new_size, nullptr);
-  for (std::size_t i = 0; i < capacity_; ++i) {
-    std::shared_ptr<Node> node = table_[i];
+  FinishRehash();
+  old_table_ = std::move(table_);
+  table_.assign(new_size, nullptr);
+  capacity_ = new_size;
+  rehash_index_ = 0;
+}
+
+void HashTable::RehashStep(std::size_t buckets) {
+  std::size_t empty_visits = kRehashMaxEmptyVisits;
+  while (IsRehashing() and buckets > 0) {
+    if (rehash_index_ == old_table_.size()) {
+      old_table_.clear();
+      old_table_.shrink_to_fit();
+      rehash_index_ = 0;
+      break;
+    }
+
+    Node* node = std::exchange(old_table_[rehash_index_++], nullptr);
+    if (node == nullptr) {
+      if (--empty_visits == 0) break;
+      continue;
+    }
     while (node != nullptr) {
-      std::size_t new_index = std::hash<Key>{}(node->key) % new_size;
-      std::shared_ptr<Node> next_node = node->next;
-      node->next = new_table[new_index];
-      new_table[new_index] = node;
+      std::size_t new_index = BucketIndex(node->hash, capacity_);
+      Node* next_node = node->next;
+      node->next = table_[new_index];
+      table_[new_index] = node;
       node = next_node;
     }
+    --buckets;
   }
+}
 
-  capacity_ = new_size;
-  table_ = std::move(new_table);
+void HashTable::FinishRehash() {
+  while (IsRehashing()) {
+    RehashStep(old_table_.size());
+  }
+}
+
+void HashTable::CollectRange(const std::vector<Node*>& table,
+                             std::uint64_t begin, std::uint64_t last,
+                             std::vector<Key>& keys) const {
+  std::size_t first_bucket = BucketIndex(begin, table.size());
+  std::size_t last_bucket = BucketIndex(last, table.size());
+  for (std::size_t i = first_bucket; i <= last_bucket; ++i) {
+    for (const Node* node = table[i]; node != nullptr; node = node->next) {
+      if (node->hash >= begin and node->hash <= last) {
+        keys.push_back(node->key);
+      }
+    }
+  }
+}
+
+void HashTable::ForEachNode(
+    const std::function<void(const Node&)>& func) const {
+  for (const auto* table : {&old_table_, &table_}) {
+    for (const auto& bucket : *table) {
+      for (const Node* node = bucket; node != nullptr; node = node->next) {
+        func(*node);
+      }
+    }
+  }
 }
 
 }  // namespace s21
@@ -2,9 +2,12 @@
 #define TRANSACTIONS_HASH_TABLE_HASH_TABLE_H_
 
 #include <fstream>
+#include <functional>
 #include <memory>
 
 #include "../common/abstract_store.h"
+#include "../common/object_pool.h"
+#include "hash_functions.h"
 
 namespace s21 {
 
@@ -15,46 +18,114 @@ namespace s21 {
  * provides methods to set and retrieve key-value pairs, check for existence,
  * delete records, update values, retrieve keys, rename keys, and perform
  * various other operations.
+ *
+ * Growing the table never rehashes all the records at once. Resize allocates
+ * the new bucket array next to the old one and every following insertion or
+ * deletion migrates a few old buckets, while lookups check both arrays until
+ * the old one is drained.
+ *
+ * Nodes are allocated from an ObjectPool and chained through plain pointers,
+ * so inserts do not hit the general-purpose allocator and chain walks do not
+ * touch reference counters. Every node also keeps the full hash of its key:
+ * resizes only remap the stored hashes, and chain walks compare hashes first
+ * so most mismatching keys are rejected without a string comparison.
+ *
+ * The hash function is a strategy chosen at construction (wyhash by default)
+ * and hashes are mapped onto buckets with FastRange, a multiply-shift
+ * reduction that avoids an integer division per operation.
+ *
+ * The table shrinks by half once its load factor drops below kMinLoadFactor.
+ * The gap between this threshold and kMaxLoadFactor keeps a table that
+ * oscillates around one size from resizing back and forth. Compact rebuilds
+ * the table at the smallest fitting capacity and repacks the live nodes into
+ * fresh slabs, returning the memory freed by mass deletions.
+ *
+ * MGet resolves a batch of keys in a software pipeline: all keys are hashed
+ * and their bucket slots prefetched up front, then the first node of the
+ * chain kPrefetchDistance keys ahead is prefetched while the current key is
+ * compared. The cache misses of independent lookups overlap instead of
+ * being paid one after another.
+ *
+ * Scan visits the buckets in index order. Since FastRange is monotonic, every
+ * bucket holds a contiguous range of hash values, and the cursor is the first
+ * hash value not scanned yet rather than a raw bucket index. The cursor stays
+ * valid across resizes and incremental rehashing: the scan resumes in the
+ * bucket owning that hash value and skips the nodes below it.
  */
 class HashTable : public AbstractStore {
  public:
-  explicit HashTable(std::size_t capacity = kTableCapacity);
+  static constexpr std::size_t kDefaultCapacity = 256;
+
+  explicit HashTable(std::size_t capacity = kDefaultCapacity,
+                     Hasher hasher = WyHash);
+  HashTable(const HashTable&) = delete;
+  HashTable& operator=(const HashTable&) = delete;
+  ~HashTable() override;
 
   bool Set(const Key& key, const Value& value) override;
-  std::optional<Value> Get(const Key& key) const override;
-  bool Exists(const Key& key) const override;
-  bool Del(const Key& key) override;
+  std::optional<Value> Get(KeyView key) const override;
+  bool Exists(KeyView key) const override;
+  bool Del(KeyView key) override;
   bool Update(const Key& key, const std::string& new_value) override;
   std::vector<Key> Keys() const override;
   bool Rename(const Key& old_key, const Key& new_key) override;
-  std::optional<std::size_t> TTL(const Key& key) const override;
+  std::optional<std::size_t> TTL(KeyView key) const override;
   std::vector<Key> Find(const std::string& value) const override;
   std::vector<Value> ShowAll() const override;
   std::size_t Upload(const std::string& file_path) override;
   std::size_t Export(const std::string& file_path) const override;
   void DeleteExpiredElements() override;
+  std::vector<std::optional<Value>> MGet(
+      const std::vector<Key>& keys) const override;
+  ScanResult Scan(const std::string& cursor, std::size_t count) const override;
+  bool HasBoundedScan() const override { return true; }
+
+  void Compact();
+  std::size_t Size() const;
+  std::size_t Capacity() const;
+  bool IsRehashing() const;
+  std::vector<std::size_t> ChainLengths() const;
 
  private:
   struct Node {
     Key key;
     Value value;
-    std::shared_ptr<Node> next;
+    std::size_t hash;
+    Node* next;
 
-    Node(const Key& k, const Value& v) : key(k), value(v), next(nullptr) {}
+    Node(Key k, Value v, std::size_t h)
+        : key(std::move(k)), value(std::move(v)), hash(h), next(nullptr) {}
   };
 
-  static constexpr std::size_t kTableCapacity = 256;
   static constexpr float kMaxLoadFactor = 0.75;
+  static constexpr float kMinLoadFactor = 0.125;
+  static constexpr std::size_t kRehashStep = 4;
+  static constexpr std::size_t kRehashMaxEmptyVisits = kRehashStep * 10;
+  static constexpr std::size_t kPrefetchDistance = 8;
+  static constexpr std::size_t kScanEmptyVisits = 10;
 
   std::size_t capacity_;
   std::size_t size_;
-  std::vector<std::shared_ptr<Node>> table_;
+  std::vector<Node*> table_;
+  std::vector<Node*> old_table_;
+  std::size_t rehash_index_;
+  Hasher hasher_;
+  ObjectPool<Node> pool_;
 
-  std::size_t HashFunction(const Key& key) const;
-  std::shared_ptr<Node> FindNode(const Key& key) const;
-  void InsertNode(const Key& key, const Value& value);
-  void DeleteNode(const Key& key);
+  std::size_t HashFunction(KeyView key) const;
+  std::size_t BucketIndex(std::size_t hash, std::size_t capacity) const;
+  Node* FindNode(KeyView key) const;
+  Node* FindNode(KeyView key, std::size_t hash) const;
+  void PrefetchBucket(std::size_t hash) const;
+  void PrefetchChain(std::size_t hash) const;
+  void InsertNode(const Key& key, const Value& value, std::size_t hash);
+  void DeleteNode(KeyView key, std::size_t hash);
   void Resize(std::size_t new_size);
+  void RehashStep(std::size_t buckets);
+  void FinishRehash();
+  void ForEachNode(const std::function<void(const Node&)>& func) const;
+  void CollectRange(const std::vector<Node*>& table, std::uint64_t begin,
+                    std::uint64_t last, std::vector<Key>& keys) const;
 };
 
 }  // namespace s21
@@ -0,0 +1,288 @@
+#include "buffer_pool.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace s21 {
+
+namespace {
+
+constexpr std::uint32_t kMagic = 0x42503153;  // "S1PB"
+
+void PutNumber(char*& out, std::uint64_t number, std::size_t width) {
+  for (std::size_t i = 0; i < width; ++i) {
+    *out++ = static_cast<char>(number >> (8 * i));
+  }
+}
+
+std::uint64_t GetNumber(const char*& in, std::size_t width) {
+  std::uint64_t number = 0;
+  for (std::size_t i = 0; i < width; ++i) {
+    number |= std::uint64_t(static_cast<unsigned char>(*in++)) << (8 * i);
+  }
+  return number;
+}
+
+}  // namespace
+
+BufferPool::PageRef::PageRef(PageRef&& other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr)), frame_(other.frame_) {}
+
+BufferPool::PageRef& BufferPool::PageRef::operator=(PageRef&& other) noexcept {
+  if (this != &other) {
+    if (pool_ != nullptr) --pool_->frames_[frame_].pins;
+    pool_ = std::exchange(other.pool_, nullptr);
+    frame_ = other.frame_;
+  }
+  return *this;
+}
+
+BufferPool::PageRef::~PageRef() {
+  if (pool_ != nullptr) --pool_->frames_[frame_].pins;
+}
+
+PagedNode& BufferPool::PageRef::operator*() const {
+  return pool_->frames_[frame_].node;
+}
+
+PagedNode* BufferPool::PageRef::operator->() const {
+  return &pool_->frames_[frame_].node;
+}
+
+/**
+ * @brief Returns the page the reference pins.
+ */
+PageId BufferPool::PageRef::Page() const { return pool_->frames_[frame_].page; }
+
+/**
+ * @brief Marks the page as changed, so that it is written back before its
+ * frame is reused.
+ */
+void BufferPool::PageRef::MarkDirty() const {
+  pool_->frames_[frame_].dirty = true;
+}
+
+/**
+ * @brief Opens a data file, creating it when it does not exist.
+ *
+ * @param file_path The path to the data file.
+ * @param frame_count The number of pages kept in memory.
+ * @throw std::invalid_argument if the file cannot be opened or frame_count is
+ * below kMinFrames.
+ * @throw std::runtime_error if the file is not a B+ tree data file.
+ */
+BufferPool::BufferPool(const std::string& file_path, std::size_t frame_count)
+    : frames_(frame_count), buffer_(PagedNode::kPageSize) {
+  if (frame_count < kMinFrames) {
+    throw std::invalid_argument("Too few buffer pool frames");
+  }
+  file_.rdbuf()->pubsetbuf(nullptr, 0);
+  file_.open(file_path, std::ios::in | std::ios::out | std::ios::binary);
+  if (!file_.is_open()) {
+    std::ofstream(file_path, std::ios::binary);
+    file_.open(file_path, std::ios::in | std::ios::out | std::ios::binary);
+  }
+  if (!file_.is_open()) {
+    throw std::invalid_argument("Invalid file_path");
+  }
+
+  file_.seekg(0, std::ios::end);
+  if (file_.tellg() == 0) {
+    WriteHeader();
+  } else {
+    ReadHeader();
+  }
+  page_table_.reserve(frame_count);
+}
+
+/**
+ * @brief Writes back the dirty pages and the header.
+ */
+BufferPool::~BufferPool() {
+  try {
+    Flush();
+  } catch (const std::exception&) {
+  }
+}
+
+/**
+ * @brief Pins a page, reading it from the file unless it is cached.
+ *
+ * @param page The page to pin.
+ * @return The reference that holds the pin.
+ * @throw std::runtime_error if every frame is pinned or the read fails.
+ */
+BufferPool::PageRef BufferPool::Fetch(PageId page) {
+  auto it = page_table_.find(page);
+  if (it != page_table_.end()) {
+    ++hits_;
+    return Pin(it->second, page);
+  }
+
+  ++misses_;
+  std::size_t frame = Victim();
+  Evict(frame);
+  ReadPage(page);
+  frames_[frame].node.Deserialize(buffer_.data());
+  page_table_.emplace(page, frame);
+  return Pin(frame, page);
+}
+
+/**
+ * @brief Allocates a page holding an empty node of the given type.
+ *
+ * A freed page is reused when there is one; otherwise the file grows by a
+ * page once the new page is written back.
+ *
+ * @param type The type of the new node.
+ * @return The reference that pins the new page, already marked dirty.
+ */
+BufferPool::PageRef BufferPool::Create(PagedNode::Type type) {
+  PageRef ref;
+  if (free_head_ != PagedNode::kNullPage) {
+    ref = Fetch(free_head_);
+    free_head_ = ref->next;
+  } else {
+    std::size_t frame = Victim();
+    Evict(frame);
+    page_table_.emplace(page_count_, frame);
+    ref = Pin(frame, page_count_++);
+  }
+
+  *ref = PagedNode();
+  ref->type = type;
+  ref.MarkDirty();
+  return ref;
+}
+
+/**
+ * @brief Returns a page to the free list.
+ *
+ * @param page The reference to the page, which must be its only pin.
+ */
+void BufferPool::Free(PageRef page) {
+  *page = PagedNode();
+  page->next = free_head_;
+  free_head_ = page.Page();
+  page.MarkDirty();
+}
+
+/**
+ * @brief Writes back every dirty page and the header, then flushes the file.
+ *
+ * @throw std::runtime_error if a write fails.
+ */
+void BufferPool::Flush() {
+  for (Frame& frame : frames_) {
+    if (frame.dirty) {
+      frame.node.Serialize(buffer_.data());
+      WritePage(frame.page);
+      frame.dirty = false;
+    }
+  }
+  WriteHeader();
+  file_.flush();
+}
+
+/**
+ * @brief Picks the frame for a page that is not cached, using the CLOCK
+ * algorithm.
+ *
+ * @return The index of an empty frame or of an unpinned frame that was not
+ * used since the hand last passed it.
+ * @throw std::runtime_error if every frame is pinned.
+ */
+std::size_t BufferPool::Victim() {
+  for (std::size_t step = 0; step < 2 * frames_.size(); ++step) {
+    std::size_t frame = hand_;
+    hand_ = (hand_ + 1) % frames_.size();
+    if (frames_[frame].page == PagedNode::kNullPage) {
+      return frame;
+    }
+    if (frames_[frame].pins > 0) {
+      continue;
+    }
+    if (frames_[frame].referenced) {
+      frames_[frame].referenced = false;
+    } else {
+      return frame;
+    }
+  }
+  throw std::runtime_error("All buffer pool frames are pinned");
+}
+
+/**
+ * @brief Empties a frame, writing its page back first if it is dirty.
+ */
+void BufferPool::Evict(std::size_t frame) {
+  Frame& victim = frames_[frame];
+  if (victim.page == PagedNode::kNullPage) {
+    return;
+  }
+  if (victim.dirty) {
+    victim.node.Serialize(buffer_.data());
+    WritePage(victim.page);
+    victim.dirty = false;
+  }
+  page_table_.erase(victim.page);
+  victim.page = PagedNode::kNullPage;
+}
+
+BufferPool::PageRef BufferPool::Pin(std::size_t frame, PageId page) {
+  frames_[frame].page = page;
+  frames_[frame].referenced = true;
+  ++frames_[frame].pins;
+  return PageRef(this, frame);
+}
+
+void BufferPool::ReadPage(PageId page) {
+  if (page == 0 or page >= page_count_) {
+    throw std::runtime_error("Page out of range");
+  }
+  file_.seekg(std::streamoff(page) * PagedNode::kPageSize);
+  if (!file_.read(buffer_.data(), PagedNode::kPageSize)) {
+    file_.clear();
+    throw std::runtime_error("Failed to read page");
+  }
+}
+
+void BufferPool::WritePage(PageId page) {
+  file_.seekp(std::streamoff(page) * PagedNode::kPageSize);
+  if (!file_.write(buffer_.data(), PagedNode::kPageSize)) {
+    file_.clear();
+    throw std::runtime_error("Failed to write page");
+  }
+}
+
+void BufferPool::ReadHeader() {
+  file_.seekg(0);
+  if (!file_.read(buffer_.data(), PagedNode::kPageSize)) {
+    throw std::runtime_error("Not a B+ tree data file");
+  }
+  const char* in = buffer_.data();
+  if (GetNumber(in, 4) != kMagic or GetNumber(in, 4) != PagedNode::kPageSize) {
+    throw std::runtime_error("Not a B+ tree data file");
+  }
+  root_ = static_cast<PageId>(GetNumber(in, 4));
+  page_count_ = static_cast<PageId>(GetNumber(in, 4));
+  free_head_ = static_cast<PageId>(GetNumber(in, 4));
+  record_count_ = GetNumber(in, 8);
+  if (page_count_ == 0) {
+    throw std::runtime_error("Not a B+ tree data file");
+  }
+}
+
+void BufferPool::WriteHeader() {
+  std::fill(buffer_.begin(), buffer_.end(), 0);
+  char* out = buffer_.data();
+  PutNumber(out, kMagic, 4);
+  PutNumber(out, PagedNode::kPageSize, 4);
+  PutNumber(out, root_, 4);
+  PutNumber(out, page_count_, 4);
+  PutNumber(out, free_head_, 4);
+  PutNumber(out, record_count_, 8);
+  WritePage(0);
+}
+
+}  // namespace s21
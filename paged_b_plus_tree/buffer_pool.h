@@ -0,0 +1,118 @@
+#ifndef TRANSACTIONS_PAGED_B_PLUS_TREE_BUFFER_POOL_H_
+#define TRANSACTIONS_PAGED_B_PLUS_TREE_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paged_node.h"
+
+namespace s21 {
+
+/**
+ * @brief Caches the pages of a B+ tree data file in a fixed number of frames.
+ *
+ * The file is an array of PagedNode::kPageSize byte pages. Page 0 holds the
+ * file header: the root page, the number of records, the number of pages and
+ * the head of the list of free pages. Every other page holds one node.
+ *
+ * A frame keeps its page decoded as a PagedNode, so a page that is already
+ * cached costs a hash lookup and no parsing. Fetch pins the frame for as long
+ * as the returned PageRef lives; a pinned frame is never evicted. When a page
+ * that is not cached is needed, a frame is picked with the CLOCK algorithm:
+ * the hand sweeps the frames, clearing the reference bit of the ones used
+ * since its last pass and taking the first unpinned frame whose bit is clear.
+ * A dirty frame is written back to the file before it is reused, and Flush
+ * writes back all of them together with the header.
+ *
+ * Freed pages are chained through their first bytes and handed out again by
+ * Create before the file grows.
+ */
+class BufferPool {
+ public:
+  static constexpr std::size_t kMinFrames = 8;
+
+  /**
+   * @brief A pinned page. Moving the reference keeps the pin; destroying or
+   * reassigning it releases the pin.
+   */
+  class PageRef {
+   public:
+    PageRef() = default;
+    PageRef(PageRef&& other) noexcept;
+    PageRef& operator=(PageRef&& other) noexcept;
+    PageRef(const PageRef&) = delete;
+    PageRef& operator=(const PageRef&) = delete;
+    ~PageRef();
+
+    explicit operator bool() const { return pool_ != nullptr; }
+    PagedNode& operator*() const;
+    PagedNode* operator->() const;
+    PageId Page() const;
+    void MarkDirty() const;
+
+   private:
+    friend class BufferPool;
+
+    PageRef(BufferPool* pool, std::size_t frame) : pool_(pool), frame_(frame) {}
+
+    BufferPool* pool_ = nullptr;
+    std::size_t frame_ = 0;
+  };
+
+  BufferPool(const std::string& file_path, std::size_t frame_count);
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+  ~BufferPool();
+
+  PageRef Fetch(PageId page);
+  PageRef Create(PagedNode::Type type);
+  void Free(PageRef page);
+  void Flush();
+
+  PageId Root() const { return root_; }
+  void SetRoot(PageId page) { root_ = page; }
+  std::uint64_t RecordCount() const { return record_count_; }
+  void SetRecordCount(std::uint64_t count) { record_count_ = count; }
+
+  std::size_t PageCount() const { return page_count_; }
+  std::size_t FrameCount() const { return frames_.size(); }
+  std::size_t Hits() const { return hits_; }
+  std::size_t Misses() const { return misses_; }
+
+ private:
+  struct Frame {
+    PageId page = PagedNode::kNullPage;
+    PagedNode node;
+    std::size_t pins = 0;
+    bool dirty = false;
+    bool referenced = false;
+  };
+
+  std::size_t Victim();
+  void Evict(std::size_t frame);
+  PageRef Pin(std::size_t frame, PageId page);
+  void ReadPage(PageId page);
+  void WritePage(PageId page);
+  void ReadHeader();
+  void WriteHeader();
+
+  std::fstream file_;
+  std::vector<Frame> frames_;
+  std::unordered_map<PageId, std::size_t> page_table_;
+  std::vector<char> buffer_;
+  std::size_t hand_ = 0;
+  PageId root_ = PagedNode::kNullPage;
+  std::uint64_t record_count_ = 0;
+  PageId page_count_ = 1;
+  PageId free_head_ = PagedNode::kNullPage;
+  std::size_t hits_ = 0;
+  std::size_t misses_ = 0;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_PAGED_B_PLUS_TREE_BUFFER_POOL_H_
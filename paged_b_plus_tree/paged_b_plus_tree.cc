@@ -0,0 +1,536 @@
+#include "paged_b_plus_tree.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include "../b_plus_tree/b_plus_node.h"
+
+namespace s21 {
+
+/**
+ * @brief Opens the store kept in a data file, creating an empty one when the
+ * file does not exist or is empty.
+ *
+ * @param file_path The path to the data file.
+ * @param frame_count The number of pages the buffer pool keeps in memory.
+ */
+PagedBPlusTree::PagedBPlusTree(const std::string& file_path,
+                               std::size_t frame_count)
+    : pool_(file_path, frame_count) {
+  if (pool_.Root() == PagedNode::kNullPage) {
+    pool_.SetRoot(pool_.Create(PagedNode::Type::kLeaf).Page());
+  }
+}
+
+/**
+ * @brief Sets the value for the specified key in the key-value store.
+ *
+ * @param key The key to set.
+ * @param value The value associated with the key.
+ * @return True if the key-value pair is successfully set, false otherwise.
+ * @throw std::length_error if the record does not fit in kMaxRecordSize.
+ */
+bool PagedBPlusTree::Set(const Key& key, const Value& value) {
+  return Insert(key, value.ToBytes(), false);
+}
+
+/**
+ * @brief Retrieves the value associated with the specified key from the
+ * key-value store.
+ *
+ * @param key The key to retrieve.
+ * @return An optional containing the value if the key is found, or an empty
+ * optional otherwise.
+ */
+std::optional<Value> PagedBPlusTree::Get(KeyView key) const {
+  PageRef leaf = FindLeaf(key, nullptr);
+  std::size_t idx = leaf->LowerBound(key);
+  if (idx < leaf->keys.size() and leaf->keys[idx] == key) {
+    return Value::FromBytes(leaf->values[idx]);
+  }
+  return std::nullopt;
+}
+
+/**
+ * @brief Checks if a record with the given key exists in the key-value store.
+ *
+ * @param key The key to check.
+ * @return True if the key exists, false otherwise.
+ */
+bool PagedBPlusTree::Exists(KeyView key) const {
+  PageRef leaf = FindLeaf(key, nullptr);
+  std::size_t idx = leaf->LowerBound(key);
+  return idx < leaf->keys.size() and leaf->keys[idx] == key;
+}
+
+/**
+ * @brief Deletes the record with the specified key from the key-value store.
+ *
+ * @param key The key to delete.
+ * @return True if the record is successfully deleted, false otherwise.
+ */
+bool PagedBPlusTree::Del(KeyView key) {
+  Path path;
+  PageRef leaf = FindLeaf(key, &path);
+  std::size_t idx = leaf->LowerBound(key);
+  if (idx == leaf->keys.size() or leaf->keys[idx] != key) {
+    return false;
+  }
+
+  leaf->keys.erase(leaf->keys.begin() + idx);
+  leaf->values.erase(leaf->values.begin() + idx);
+  leaf.MarkDirty();
+  pool_.SetRecordCount(pool_.RecordCount() - 1);
+  if (leaf->keys.empty() and !path.empty()) {
+    Unlink(std::move(leaf), path);
+    CollapseRoot();
+  }
+  return true;
+}
+
+/**
+ * @brief Updates the value associated with the specified key in the key-value
+ * store.
+ *
+ * @param key The key to update.
+ * @param new_value The new value to set.
+ * @return True if the value is successfully updated, false otherwise.
+ */
+bool PagedBPlusTree::Update(const Key& key, const std::string& new_value) {
+  std::optional<Value> value = Get(key);
+  if (!value) {
+    return false;
+  }
+
+  value->Update(new_value);
+  Insert(key, value->ToBytes(), true);
+  return true;
+}
+
+/**
+ * @brief Retrieves all the keys stored in the tree.
+ *
+ * @return A vector containing all the keys in ascending order.
+ */
+std::vector<Key> PagedBPlusTree::Keys() const {
+  std::vector<Key> keys;
+  keys.reserve(Size());
+  WalkFrom("", [&keys](const Key& key, const std::string&) {
+    keys.push_back(key);
+    return true;
+  });
+  return keys;
+}
+
+/**
+ * @brief Returns up to count keys in ascending order, starting after the key
+ * stored in the cursor.
+ *
+ * @param cursor An empty string to start, or a cursor returned by Scan.
+ * @param count The maximum number of keys to return.
+ * @return The keys and the cursor of the next batch, empty at the end.
+ */
+AbstractStore::ScanResult PagedBPlusTree::Scan(const std::string& cursor,
+                                               std::size_t count) const {
+  if (count == 0) count = 1;
+  Key after = cursor.empty() ? Key() : ParseKeyCursor(cursor);
+
+  ScanResult result;
+  WalkFrom(after, [&](const Key& key, const std::string&) {
+    if (!cursor.empty() and key == after) {
+      return true;
+    }
+    if (result.keys.size() == count) {
+      result.cursor = KeyCursor(result.keys.back());
+      return false;
+    }
+    result.keys.push_back(key);
+    return true;
+  });
+  return result;
+}
+
+/**
+ * @brief Visits the keys from lo to hi inclusive, in ascending order.
+ *
+ * @param lo The smallest key to visit.
+ * @param hi The largest key to visit.
+ * @param visit Called with each key and its value; returning false stops the
+ * walk.
+ */
+void PagedBPlusTree::ForEachInRange(KeyView lo, KeyView hi,
+                                    const RangeVisitor& visit) const {
+  if (hi < lo) return;
+  WalkFrom(lo, [hi, &visit](const Key& key, const std::string& value) {
+    return KeyView(key) <= hi and visit(key, Value::FromBytes(value));
+  });
+}
+
+/**
+ * @brief Visits the keys that start with the prefix, in ascending order.
+ *
+ * @param prefix The prefix of the keys to visit.
+ * @param visit Called with each key and its value; returning false stops the
+ * walk.
+ */
+void PagedBPlusTree::ForEachWithPrefix(KeyView prefix,
+                                       const RangeVisitor& visit) const {
+  WalkFrom(prefix, [prefix, &visit](const Key& key, const std::string& value) {
+    return HasPrefix(key, prefix) and visit(key, Value::FromBytes(value));
+  });
+}
+
+/**
+ * @brief Renames a key in the tree, keeping the value with its TTL.
+ *
+ * The record is stored under the new key before the old key is deleted, so a
+ * new key too long for a page leaves the old record in place.
+ *
+ * @param old_key The old key to rename.
+ * @param new_key The new key to replace the old key.
+ * @return True if the rename is successful, false otherwise.
+ * @throw std::length_error if the record under the new key does not fit in
+ * kMaxRecordSize.
+ */
+bool PagedBPlusTree::Rename(const Key& old_key, const Key& new_key) {
+  std::optional<Value> value = Get(old_key);
+  if (!value or !Set(new_key, *value)) {
+    return false;
+  }
+
+  Del(old_key);
+  return true;
+}
+
+/**
+ * @brief Retrieves the time-to-live (TTL) of a key in the tree.
+ *
+ * @param key The key to retrieve TTL for.
+ * @return An optional containing the TTL if available, or an empty optional
+ * otherwise.
+ */
+std::optional<std::size_t> PagedBPlusTree::TTL(KeyView key) const {
+  std::optional<Value> value = Get(key);
+  if (value) {
+    return value->TTL();
+  }
+  return std::nullopt;
+}
+
+/**
+ * @brief Finds all keys that have the given value in the tree.
+ *
+ * @param value The value to search for.
+ * @return A vector containing all the keys with the given value.
+ */
+std::vector<Key> PagedBPlusTree::Find(const std::string& value) const {
+  std::vector<Key> keys;
+  WalkFrom("", [&keys, &value](const Key& key, const std::string& bytes) {
+    if (Value::FromBytes(bytes).Match(value)) {
+      keys.push_back(key);
+    }
+    return true;
+  });
+  return keys;
+}
+
+/**
+ * @brief Shows all the values stored in the tree, in the order of their keys.
+ *
+ * @return A vector containing all the values.
+ */
+std::vector<Value> PagedBPlusTree::ShowAll() const {
+  std::vector<Value> values;
+  values.reserve(Size());
+  WalkFrom("", [&values](const Key&, const std::string& bytes) {
+    values.push_back(Value::FromBytes(bytes));
+    return true;
+  });
+  return values;
+}
+
+/**
+ * @brief Uploads key-value pairs from a file and inserts them into the tree.
+ *
+ * @param file_path The path to the file containing key-value pairs.
+ * @return The number of records read from the file.
+ */
+std::size_t PagedBPlusTree::Upload(const std::string& file_path) {
+  std::ifstream file(file_path);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Invalid file_path");
+  }
+
+  Key key;
+  std::string value;
+  std::size_t count = 0u;
+  while (file >> key) {
+    std::getline(file >> std::ws, value);
+    Insert(key, Value::FromString(value).ToBytes(), false);
+    ++count;
+  }
+  file.close();
+  return count;
+}
+
+/**
+ * @brief Exports key-value pairs from the tree to a file.
+ *
+ * @param file_path The path to the file to export key-value pairs to.
+ * @return The number of key-value pairs exported successfully.
+ */
+std::size_t PagedBPlusTree::Export(const std::string& file_path) const {
+  std::ofstream file(file_path);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Invalid file_path");
+  }
+
+  std::size_t count = 0u;
+  WalkFrom("", [&file, &count](const Key& key, const std::string& bytes) {
+    file << key << " " << Value::FromBytes(bytes).ToQuotedString() << "\n";
+    ++count;
+    return true;
+  });
+  file.close();
+  return count;
+}
+
+/**
+ * @brief Deletes expired elements from the tree.
+ */
+void PagedBPlusTree::DeleteExpiredElements() {
+  std::vector<Key> expired;
+  WalkFrom("", [&expired](const Key& key, const std::string& bytes) {
+    if (Value::FromBytes(bytes).TTL() == 0u) {
+      expired.push_back(key);
+    }
+    return true;
+  });
+  for (const Key& key : expired) {
+    Del(key);
+  }
+}
+
+/**
+ * @brief Returns the number of records in the tree.
+ */
+std::size_t PagedBPlusTree::Size() const { return pool_.RecordCount(); }
+
+/**
+ * @brief Writes every changed page and the file header to the data file.
+ */
+void PagedBPlusTree::Flush() { pool_.Flush(); }
+
+/**
+ * @brief Finds the leaf where the given key should be located.
+ *
+ * @param key The key to search for.
+ * @param path If not null, receives each internal page on the way down with
+ * the index of the child taken, from the root.
+ * @return The pinned leaf.
+ */
+PagedBPlusTree::PageRef PagedBPlusTree::FindLeaf(KeyView key,
+                                                 Path* path) const {
+  PageRef node = pool_.Fetch(pool_.Root());
+  while (!node->IsLeaf()) {
+    std::size_t idx = node->UpperBound(key);
+    if (path != nullptr) path->emplace_back(node.Page(), idx);
+    node = pool_.Fetch(node->children[idx]);
+  }
+  return node;
+}
+
+/**
+ * @brief Walks the records with keys not less than lo in ascending order.
+ *
+ * One descent finds the leaf that would hold lo; the walk then follows the
+ * leaf chain, pinning one leaf at a time, and hands the values over in their
+ * stored form so that callers decode only what they use.
+ *
+ * @param lo The smallest key to visit.
+ * @param visit Called with each key and its encoded value; returning false
+ * stops the walk.
+ */
+void PagedBPlusTree::WalkFrom(KeyView lo, const EntryVisitor& visit) const {
+  PageRef leaf = FindLeaf(lo, nullptr);
+  std::size_t offset = leaf->LowerBound(lo);
+  while (true) {
+    for (; offset < leaf->keys.size(); ++offset) {
+      if (!visit(leaf->keys[offset], leaf->values[offset])) return;
+    }
+    if (leaf->next == PagedNode::kNullPage) return;
+    leaf = pool_.Fetch(leaf->next);
+    offset = 0;
+  }
+}
+
+/**
+ * @brief Stores a record, splitting the leaf if it outgrows its page.
+ *
+ * @param key The key of the record.
+ * @param value The value in the form of Value::ToBytes.
+ * @param overwrite Whether to replace the value of an existing key.
+ * @return True if the key was not in the tree.
+ * @throw std::length_error if the record does not fit in kMaxRecordSize.
+ */
+bool PagedBPlusTree::Insert(const Key& key, std::string value, bool overwrite) {
+  if (key.size() + value.size() > kMaxRecordSize) {
+    throw std::length_error("Record does not fit in a page");
+  }
+
+  Path path;
+  PageRef leaf = FindLeaf(key, &path);
+  std::size_t idx = leaf->LowerBound(key);
+  if (idx < leaf->keys.size() and leaf->keys[idx] == key) {
+    if (overwrite) {
+      leaf->values[idx] = std::move(value);
+      leaf.MarkDirty();
+      if (leaf->ByteSize() > PagedNode::kPageSize) {
+        Split(std::move(leaf), path);
+      }
+    }
+    return false;
+  }
+
+  leaf->keys.insert(leaf->keys.begin() + idx, key);
+  leaf->values.insert(leaf->values.begin() + idx, std::move(value));
+  leaf.MarkDirty();
+  pool_.SetRecordCount(pool_.RecordCount() + 1);
+  if (leaf->ByteSize() > PagedNode::kPageSize) {
+    Split(std::move(leaf), path);
+  }
+  return true;
+}
+
+/**
+ * @brief Splits a node that outgrew its page, and its ancestors as long as
+ * adding the new separator makes them outgrow theirs too.
+ *
+ * The node keeps the entries that make up the first half of its bytes and a
+ * new right sibling takes the rest. Leaves pass up the shortest key that
+ * separates the halves; internal nodes pass up their middle key.
+ *
+ * @param node The node to split.
+ * @param path The internal pages from the root down to the node's parent.
+ */
+void PagedBPlusTree::Split(PageRef node, Path& path) {
+  while (node->ByteSize() > PagedNode::kPageSize) {
+    std::size_t half = (node->ByteSize() - PagedNode::kHeaderSize) / 2;
+    std::size_t mid = 0;
+    for (std::size_t bytes = 0; mid + 1 < node->keys.size() and
+                                bytes + node->EntrySize(mid) <= half;
+         ++mid) {
+      bytes += node->EntrySize(mid);
+    }
+    mid = std::max<std::size_t>(mid, 1);
+
+    PageRef right = pool_.Create(node->type);
+    Key separator;
+    if (node->IsLeaf()) {
+      right->keys.assign(std::make_move_iterator(node->keys.begin() + mid),
+                         std::make_move_iterator(node->keys.end()));
+      right->values.assign(std::make_move_iterator(node->values.begin() + mid),
+                           std::make_move_iterator(node->values.end()));
+      node->keys.resize(mid);
+      node->values.resize(mid);
+      right->next = node->next;
+      node->next = right.Page();
+      separator = BPlusNode::Separator(node->keys.back(), right->keys.front());
+    } else {
+      separator = std::move(node->keys[mid]);
+      right->keys.assign(std::make_move_iterator(node->keys.begin() + mid + 1),
+                         std::make_move_iterator(node->keys.end()));
+      right->children.assign(node->children.begin() + mid + 1,
+                             node->children.end());
+      node->keys.resize(mid);
+      node->children.resize(mid + 1);
+    }
+    node.MarkDirty();
+
+    if (path.empty()) {
+      PageRef root = pool_.Create(PagedNode::Type::kInternal);
+      root->keys.push_back(std::move(separator));
+      root->children = {node.Page(), right.Page()};
+      pool_.SetRoot(root.Page());
+      return;
+    }
+
+    auto [parent_page, idx] = path.back();
+    path.pop_back();
+    PageRef parent = pool_.Fetch(parent_page);
+    parent->keys.insert(parent->keys.begin() + idx, std::move(separator));
+    parent->children.insert(parent->children.begin() + idx + 1, right.Page());
+    parent.MarkDirty();
+    node = std::move(parent);
+  }
+}
+
+/**
+ * @brief Removes an empty node from its parent and releases its page.
+ *
+ * A leaf is first taken out of the leaf chain. A parent left without children
+ * is removed in turn.
+ *
+ * @param node The empty node, which must not be the root.
+ * @param path The internal pages from the root down to the node's parent.
+ */
+void PagedBPlusTree::Unlink(PageRef node, Path& path) {
+  if (node->IsLeaf()) {
+    PageRef previous = PreviousLeaf(path);
+    if (previous) {
+      previous->next = node->next;
+      previous.MarkDirty();
+    }
+  }
+  pool_.Free(std::move(node));
+
+  auto [parent_page, idx] = path.back();
+  path.pop_back();
+  PageRef parent = pool_.Fetch(parent_page);
+  parent->children.erase(parent->children.begin() + idx);
+  if (!parent->keys.empty()) {
+    parent->keys.erase(parent->keys.begin() + (idx == 0 ? 0 : idx - 1));
+  }
+  parent.MarkDirty();
+  if (parent->children.empty() and !path.empty()) {
+    Unlink(std::move(parent), path);
+  }
+}
+
+/**
+ * @brief Finds the leaf before the one the path leads to.
+ *
+ * @param path The internal pages from the root down to the leaf's parent.
+ * @return The pinned leaf, or an empty reference for the first leaf.
+ */
+PagedBPlusTree::PageRef PagedBPlusTree::PreviousLeaf(const Path& path) {
+  for (std::size_t level = path.size(); level-- > 0;) {
+    auto [page, idx] = path[level];
+    if (idx > 0) {
+      PageRef node = pool_.Fetch(page);
+      node = pool_.Fetch(node->children[idx - 1]);
+      while (!node->IsLeaf()) {
+        node = pool_.Fetch(node->children.back());
+      }
+      return node;
+    }
+  }
+  return PageRef();
+}
+
+/**
+ * @brief Replaces a root that has a single child with that child, as many
+ * times as needed.
+ */
+void PagedBPlusTree::CollapseRoot() {
+  PageRef root = pool_.Fetch(pool_.Root());
+  while (!root->IsLeaf() and root->children.size() == 1) {
+    PageId child = root->children.front();
+    pool_.Free(std::move(root));
+    pool_.SetRoot(child);
+    root = pool_.Fetch(child);
+  }
+}
+
+}  // namespace s21
@@ -0,0 +1,82 @@
+#ifndef TRANSACTIONS_PAGED_B_PLUS_TREE_PAGED_B_PLUS_TREE_H_
+#define TRANSACTIONS_PAGED_B_PLUS_TREE_PAGED_B_PLUS_TREE_H_
+
+#include <functional>
+#include <utility>
+
+#include "../common/abstract_store.h"
+#include "buffer_pool.h"
+
+namespace s21 {
+
+/**
+ * @brief Key-value store based on a B+ tree kept in a data file.
+ *
+ * Every node lives in one fixed-size page of the file and is reached through a
+ * BufferPool, so only the pages in its frames take memory and the number of
+ * records is bounded by the disk. The top levels of the tree are used by every
+ * descent and stay cached, so a lookup that finds its leaf in the pool does
+ * not touch the file.
+ *
+ * A node splits when it no longer fits in its page, halving its bytes rather
+ * than its keys, which lets keys and values vary in size. A record takes at
+ * most kMaxRecordSize bytes so that both halves of a split fit. Deleting never
+ * rebalances: a page is released to the free list of the file once its last
+ * key is gone, and a root with a single child is replaced by the child.
+ *
+ * The records persist: opening an existing data file continues where the
+ * previous store left off. Dirty pages are written back when their frame is
+ * reused, by Flush and by the destructor.
+ */
+class PagedBPlusTree : public AbstractStore {
+ public:
+  static constexpr std::size_t kDefaultFrameCount = 4096;
+  static constexpr std::size_t kMaxRecordSize = PagedNode::kPageSize / 4;
+
+  explicit PagedBPlusTree(const std::string& file_path,
+                          std::size_t frame_count = kDefaultFrameCount);
+
+  bool Set(const Key& key, const Value& value) override;
+  std::optional<Value> Get(KeyView key) const override;
+  bool Exists(KeyView key) const override;
+  bool Del(KeyView key) override;
+  bool Update(const Key& key, const std::string& new_value) override;
+  std::vector<Key> Keys() const override;
+  bool Rename(const Key& old_key, const Key& new_key) override;
+  std::optional<std::size_t> TTL(KeyView key) const override;
+  std::vector<Key> Find(const std::string& value) const override;
+  std::vector<Value> ShowAll() const override;
+  std::size_t Upload(const std::string& file_path) override;
+  std::size_t Export(const std::string& file_path) const override;
+  void DeleteExpiredElements() override;
+  ScanResult Scan(const std::string& cursor, std::size_t count) const override;
+  bool HasBoundedScan() const override { return true; }
+  void ForEachInRange(KeyView lo, KeyView hi,
+                      const RangeVisitor& visit) const override;
+  void ForEachWithPrefix(KeyView prefix,
+                         const RangeVisitor& visit) const override;
+
+  std::size_t Size() const;
+  void Flush();
+  const BufferPool& GetPool() const { return pool_; }
+
+ private:
+  using PageRef = BufferPool::PageRef;
+  using Path = std::vector<std::pair<PageId, std::size_t>>;
+  using EntryVisitor =
+      std::function<bool(const Key& key, const std::string& value)>;
+
+  PageRef FindLeaf(KeyView key, Path* path) const;
+  void WalkFrom(KeyView lo, const EntryVisitor& visit) const;
+  bool Insert(const Key& key, std::string value, bool overwrite);
+  void Split(PageRef node, Path& path);
+  void Unlink(PageRef node, Path& path);
+  PageRef PreviousLeaf(const Path& path);
+  void CollapseRoot();
+
+  mutable BufferPool pool_;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_PAGED_B_PLUS_TREE_PAGED_B_PLUS_TREE_H_
@@ -0,0 +1,144 @@
+#include "paged_node.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace s21 {
+
+namespace {
+
+void PutNumber(char*& out, std::uint32_t number, std::size_t width) {
+  for (std::size_t i = 0; i < width; ++i) {
+    *out++ = static_cast<char>(number >> (8 * i));
+  }
+}
+
+std::uint32_t GetNumber(const char*& in, std::size_t width) {
+  std::uint32_t number = 0;
+  for (std::size_t i = 0; i < width; ++i) {
+    number |= std::uint32_t(static_cast<unsigned char>(*in++)) << (8 * i);
+  }
+  return number;
+}
+
+void PutBytes(char*& out, std::string_view bytes) {
+  PutNumber(out, static_cast<std::uint32_t>(bytes.size()), 2);
+  std::memcpy(out, bytes.data(), bytes.size());
+  out += bytes.size();
+}
+
+void GetBytes(const char*& in, const char* end, std::string& bytes) {
+  if (end - in < 2) {
+    throw std::runtime_error("Corrupted page");
+  }
+  std::size_t size = GetNumber(in, 2);
+  if (size > static_cast<std::size_t>(end - in)) {
+    throw std::runtime_error("Corrupted page");
+  }
+  bytes.assign(in, size);
+  in += size;
+}
+
+}  // namespace
+
+/**
+ * @brief Returns the index of the first key not less than the given one.
+ */
+std::size_t PagedNode::LowerBound(KeyView key) const {
+  return std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+}
+
+/**
+ * @brief Returns the index of the first key greater than the given one, which
+ * in an internal node is the child to descend into.
+ */
+std::size_t PagedNode::UpperBound(KeyView key) const {
+  return std::upper_bound(keys.begin(), keys.end(), key) - keys.begin();
+}
+
+/**
+ * @brief Returns the number of page bytes the node takes when serialized.
+ */
+std::size_t PagedNode::ByteSize() const {
+  std::size_t size = kHeaderSize;
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    size += EntrySize(i);
+  }
+  return size;
+}
+
+/**
+ * @brief Returns the number of page bytes taken by the entry at idx.
+ */
+std::size_t PagedNode::EntrySize(std::size_t idx) const {
+  if (IsLeaf()) {
+    return 2 + keys[idx].size() + 2 + values[idx].size();
+  }
+  return 2 + keys[idx].size() + 4;
+}
+
+/**
+ * @brief Writes the node to a page of kPageSize bytes.
+ *
+ * @param page The page buffer; the bytes past the node are zeroed.
+ */
+void PagedNode::Serialize(char* page) const {
+  char* out = page;
+  *out++ = static_cast<char>(type);
+  PutNumber(out, static_cast<std::uint32_t>(keys.size()), 2);
+  PutNumber(out, type == Type::kInternal ? children.front() : next, 4);
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    PutBytes(out, keys[i]);
+    if (IsLeaf()) {
+      PutBytes(out, values[i]);
+    } else {
+      PutNumber(out, children[i + 1], 4);
+    }
+  }
+  std::memset(out, 0, kPageSize - (out - page));
+}
+
+/**
+ * @brief Reads the node from a page written by Serialize.
+ *
+ * The strings already in the node are overwritten in place, so a frame that
+ * is reused for another page keeps most of its allocations.
+ *
+ * @param page The page buffer of kPageSize bytes.
+ * @throw std::runtime_error if the page does not hold a valid node.
+ */
+void PagedNode::Deserialize(const char* page) {
+  const char* in = page;
+  const char* end = page + kPageSize;
+  type = static_cast<Type>(*in++);
+  if (type != Type::kFree and type != Type::kLeaf and
+      type != Type::kInternal) {
+    throw std::runtime_error("Corrupted page");
+  }
+  std::size_t count = GetNumber(in, 2);
+  PageId link = GetNumber(in, 4);
+
+  keys.resize(count);
+  values.resize(type == Type::kLeaf ? count : 0);
+  children.clear();
+  next = kNullPage;
+  if (type == Type::kInternal) {
+    children.push_back(link);
+  } else {
+    next = link;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    GetBytes(in, end, keys[i]);
+    if (IsLeaf()) {
+      GetBytes(in, end, values[i]);
+    } else {
+      if (end - in < 4) {
+        throw std::runtime_error("Corrupted page");
+      }
+      children.push_back(GetNumber(in, 4));
+    }
+  }
+}
+
+}  // namespace s21
@@ -0,0 +1,57 @@
+#ifndef TRANSACTIONS_PAGED_B_PLUS_TREE_PAGED_NODE_H_
+#define TRANSACTIONS_PAGED_B_PLUS_TREE_PAGED_NODE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../common/abstract_store.h"
+
+namespace s21 {
+
+using PageId = std::uint32_t;
+
+/**
+ * @brief A node of a PagedBPlusTree, as it is held in a buffer pool frame.
+ *
+ * A leaf keeps its values in the binary form of Value::ToBytes, so writing
+ * the node back to its page is a copy and a lookup decodes only the value it
+ * returns. An internal node has one more child than it has keys; child i
+ * holds the keys below keys[i] and not below keys[i - 1].
+ *
+ * A node fits in one page when ByteSize() is at most kPageSize. The page
+ * starts with a header of kHeaderSize bytes: the node type, the number of
+ * keys and the next leaf (or the first child of an internal node). Then come
+ * the entries, each a 16-bit key length and the key followed, in a leaf, by a
+ * 16-bit value length and the value, and in an internal node by the page of
+ * the child to the right of the key. All numbers are little-endian.
+ */
+struct PagedNode {
+  enum class Type : std::uint8_t { kFree, kLeaf, kInternal };
+
+  static constexpr std::size_t kPageSize = 4096;
+  static constexpr std::size_t kHeaderSize = 7;
+  static constexpr PageId kNullPage = std::numeric_limits<PageId>::max();
+
+  Type type = Type::kFree;
+  std::vector<Key> keys;
+  std::vector<std::string> values;
+  std::vector<PageId> children;
+  PageId next = kNullPage;
+
+  bool IsLeaf() const { return type == Type::kLeaf; }
+  std::size_t LowerBound(KeyView key) const;
+  std::size_t UpperBound(KeyView key) const;
+  std::size_t ByteSize() const;
+  std::size_t EntrySize(std::size_t idx) const;
+
+  void Serialize(char* page) const;
+  void Deserialize(const char* page);
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_PAGED_B_PLUS_TREE_PAGED_NODE_H_
@@ -0,0 +1,605 @@
+#include "persistent_tree.h"
+
+#include <algorithm>
+
+namespace s21 {
+
+/**
+ * @brief Returns a read-only view of the current version of the tree.
+ *
+ * The view shares all nodes with the tree, so it costs one pointer copy.
+ */
+PersistentTree::Snapshot PersistentTree::TakeSnapshot() const {
+  return Snapshot(Root());
+}
+
+/**
+ * @brief Sets the value for the specified key.
+ *
+ * @param key The key to set.
+ * @param value The value associated with the key.
+ * @return true if the record was inserted, false if the key already exists.
+ */
+bool PersistentTree::Set(const Key& key, const Value& value) {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  if (FindNode(root_, key) != nullptr) {
+    return false;
+  }
+  Publish(Insert(root_, key, std::make_shared<const Value>(value)));
+  return true;
+}
+
+/**
+ * @brief Retrieves the value associated with the specified key.
+ *
+ * @param key The key to retrieve.
+ * @return The value if the key is found, std::nullopt otherwise.
+ */
+std::optional<Value> PersistentTree::Get(KeyView key) const {
+  return TakeSnapshot().Get(key);
+}
+
+/**
+ * @brief Checks if a record with the given key exists.
+ *
+ * @param key The key to check.
+ * @return true if the key exists, false otherwise.
+ */
+bool PersistentTree::Exists(KeyView key) const {
+  return TakeSnapshot().Exists(key);
+}
+
+/**
+ * @brief Deletes the record with the specified key.
+ *
+ * @param key The key to delete.
+ * @return true if the record was deleted, false if the key was not found.
+ */
+bool PersistentTree::Del(KeyView key) {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  if (FindNode(root_, key) == nullptr) {
+    return false;
+  }
+  Publish(Erase(root_, key));
+  return true;
+}
+
+/**
+ * @brief Updates the value associated with the specified key.
+ *
+ * @param key The key to update.
+ * @param new_value The new value, '-' keeps a field unchanged.
+ * @return true if the value was updated, false if the key was not found.
+ */
+bool PersistentTree::Update(const Key& key, const std::string& new_value) {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  const Node* node = FindNode(root_, key);
+  if (node == nullptr) {
+    return false;
+  }
+  Value value = *node->value;
+  value.Update(new_value);
+  Publish(Replace(root_, key, std::make_shared<const Value>(value)));
+  return true;
+}
+
+/**
+ * @brief Retrieves all keys in ascending order.
+ *
+ * @return A vector containing all keys.
+ */
+std::vector<Key> PersistentTree::Keys() const { return TakeSnapshot().Keys(); }
+
+/**
+ * @brief Renames a key, as one change visible to readers.
+ *
+ * @param old_key The key to rename.
+ * @param new_key The new name of the key.
+ * @return true if the key was renamed, false if old_key was not found or
+ * new_key already exists.
+ */
+bool PersistentTree::Rename(const Key& old_key, const Key& new_key) {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  const Node* node = FindNode(root_, old_key);
+  if (node == nullptr) {
+    return false;
+  }
+  if (old_key == new_key) {
+    return true;
+  }
+  if (FindNode(root_, new_key) != nullptr) {
+    return false;
+  }
+  ValuePtr value = node->value;
+  Publish(Insert(Erase(root_, old_key), new_key, std::move(value)));
+  return true;
+}
+
+/**
+ * @brief Returns the remaining time to live of the specified key.
+ *
+ * @param key The key to check.
+ * @return The TTL, or std::nullopt if the key is not found or has no TTL.
+ */
+std::optional<std::size_t> PersistentTree::TTL(KeyView key) const {
+  return TakeSnapshot().TTL(key);
+}
+
+/**
+ * @brief Finds the keys whose values match the given value.
+ *
+ * @param value The value to match, '-' matches any field.
+ * @return The matching keys in ascending order.
+ */
+std::vector<Key> PersistentTree::Find(const std::string& value) const {
+  return TakeSnapshot().Find(value);
+}
+
+/**
+ * @brief Retrieves all values in the order of their keys.
+ *
+ * @return A vector containing all values.
+ */
+std::vector<Value> PersistentTree::ShowAll() const {
+  return TakeSnapshot().ShowAll();
+}
+
+/**
+ * @brief Uploads key-value pairs from a file.
+ *
+ * The records are applied to a private version of the tree that is published
+ * once the whole file has been read.
+ *
+ * @param file_path The path to the file containing key-value pairs.
+ * @return The number of records read from the file.
+ */
+std::size_t PersistentTree::Upload(const std::string& file_path) {
+  std::ifstream file(file_path);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Invalid file_path");
+  }
+
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  NodePtr root = root_;
+  Key key;
+  std::string value;
+
+  std::size_t count = 0u;
+  while (file >> key) {
+    std::getline(file >> std::ws, value);
+    if (FindNode(root, key) == nullptr) {
+      root = Insert(root, key,
+                    std::make_shared<const Value>(Value::FromString(value)));
+    }
+    ++count;
+  }
+
+  file.close();
+  Publish(std::move(root));
+  return count;
+}
+
+/**
+ * @brief Exports a consistent snapshot of the records to a file.
+ *
+ * @param file_path The path to the file to export key-value pairs to.
+ * @return The number of records written to the file.
+ */
+std::size_t PersistentTree::Export(const std::string& file_path) const {
+  return TakeSnapshot().Export(file_path);
+}
+
+/**
+ * @brief Deletes expired elements, as one change visible to readers.
+ */
+void PersistentTree::DeleteExpiredElements() {
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  std::vector<Key> expired;
+  Snapshot(root_).ForEach([&expired](const Node& node) {
+    if (node.value->TTL() == 0u) {
+      expired.push_back(node.key);
+    }
+  });
+  if (expired.empty()) {
+    return;
+  }
+
+  NodePtr root = root_;
+  for (const Key& key : expired) {
+    root = Erase(root, key);
+  }
+  Publish(std::move(root));
+}
+
+/**
+ * @brief Returns up to count keys in ascending order, starting after the key
+ * stored in the cursor.
+ *
+ * @param cursor An empty string to start, or a cursor returned by Scan.
+ * @param count The maximum number of keys to return.
+ * @return The keys and the cursor of the next batch, empty at the end.
+ */
+AbstractStore::ScanResult PersistentTree::Scan(const std::string& cursor,
+                                               std::size_t count) const {
+  return TakeSnapshot().Scan(cursor, count);
+}
+
+/**
+ * @brief Returns the current root, which readers share with the tree.
+ */
+PersistentTree::NodePtr PersistentTree::Root() const {
+  std::lock_guard<std::mutex> lock(root_mutex_);
+  return root_;
+}
+
+/**
+ * @brief Makes a new version of the tree visible to readers.
+ *
+ * Nodes only the old version used are released after the lock is dropped, so
+ * readers do not wait for them to be freed. Must be called with write_mutex_
+ * held.
+ *
+ * @param root The root of the new version.
+ */
+void PersistentTree::Publish(NodePtr root) {
+  NodePtr old_root;
+  {
+    std::lock_guard<std::mutex> lock(root_mutex_);
+    old_root = std::move(root_);
+    root_ = std::move(root);
+  }
+}
+
+/**
+ * @brief Finds the node with the given key.
+ *
+ * @param root The root of the version to search.
+ * @param key The key to search for.
+ * @return The node, or nullptr if the key is not found.
+ */
+const PersistentTree::Node* PersistentTree::FindNode(const NodePtr& root,
+                                                     KeyView key) {
+  const Node* node = root.get();
+  while (node != nullptr and node->key != key) {
+    node = (key < node->key) ? node->left.get() : node->right.get();
+  }
+  return node;
+}
+
+/**
+ * @brief Returns the height of a subtree, -1 for an empty one.
+ */
+int PersistentTree::Height(const NodePtr& node) {
+  return node ? node->height : -1;
+}
+
+/**
+ * @brief Builds a node above two subtrees.
+ */
+PersistentTree::NodePtr PersistentTree::MakeNode(const Key& key,
+                                                 ValuePtr value, NodePtr left,
+                                                 NodePtr right) {
+  int height = std::max(Height(left), Height(right)) + 1;
+  return std::make_shared<const Node>(
+      Node{key, std::move(value), std::move(left), std::move(right), height});
+}
+
+/**
+ * @brief Builds a copy of a node with other subtrees.
+ */
+PersistentTree::NodePtr PersistentTree::CopyNode(const Node& node,
+                                                 NodePtr left, NodePtr right) {
+  return MakeNode(node.key, node.value, std::move(left), std::move(right));
+}
+
+/**
+ * @brief Builds a copy of a node with other subtrees, rotating the copies if
+ * their heights differ by two.
+ *
+ * @param node The node that supplies the key and the value.
+ * @param left The new left subtree.
+ * @param right The new right subtree.
+ * @return The root of the balanced subtree.
+ */
+PersistentTree::NodePtr PersistentTree::Balance(const Node& node, NodePtr left,
+                                                NodePtr right) {
+  int balance = Height(right) - Height(left);
+  if (balance > 1) {
+    if (Height(right->left) > Height(right->right)) {
+      const Node& pivot = *right->left;
+      return CopyNode(pivot, CopyNode(node, std::move(left), pivot.left),
+                      CopyNode(*right, pivot.right, right->right));
+    }
+    return CopyNode(*right, CopyNode(node, std::move(left), right->left),
+                    right->right);
+  }
+  if (balance < -1) {
+    if (Height(left->right) > Height(left->left)) {
+      const Node& pivot = *left->right;
+      return CopyNode(pivot, CopyNode(*left, left->left, pivot.left),
+                      CopyNode(node, pivot.right, std::move(right)));
+    }
+    return CopyNode(*left, left->left,
+                    CopyNode(node, left->right, std::move(right)));
+  }
+  return CopyNode(node, std::move(left), std::move(right));
+}
+
+/**
+ * @brief Inserts a key that is not in the subtree yet.
+ *
+ * @return The root of a new version of the subtree.
+ */
+PersistentTree::NodePtr PersistentTree::Insert(const NodePtr& node,
+                                               const Key& key, ValuePtr value) {
+  if (!node) {
+    return MakeNode(key, std::move(value), nullptr, nullptr);
+  }
+  if (key < node->key) {
+    return Balance(*node, Insert(node->left, key, std::move(value)),
+                   node->right);
+  }
+  return Balance(*node, node->left, Insert(node->right, key, std::move(value)));
+}
+
+/**
+ * @brief Removes a key that is present in the subtree.
+ *
+ * @return The root of a new version of the subtree.
+ */
+PersistentTree::NodePtr PersistentTree::Erase(const NodePtr& node,
+                                              KeyView key) {
+  if (key < node->key) {
+    return Balance(*node, Erase(node->left, key), node->right);
+  }
+  if (key > node->key) {
+    return Balance(*node, node->left, Erase(node->right, key));
+  }
+  if (!node->left) {
+    return node->right;
+  }
+  if (!node->right) {
+    return node->left;
+  }
+  const Node* min = nullptr;
+  NodePtr right = EraseMin(node->right, min);
+  return Balance(*min, node->left, std::move(right));
+}
+
+/**
+ * @brief Removes the smallest key of a non-empty subtree.
+ *
+ * @param node The root of the subtree.
+ * @param min Receives the removed node, which the old version keeps alive.
+ * @return The root of a new version of the subtree.
+ */
+PersistentTree::NodePtr PersistentTree::EraseMin(const NodePtr& node,
+                                                 const Node*& min) {
+  if (!node->left) {
+    min = node.get();
+    return node->right;
+  }
+  return Balance(*node, EraseMin(node->left, min), node->right);
+}
+
+/**
+ * @brief Replaces the value of a key that is present in the subtree.
+ *
+ * @return The root of a new version of the subtree.
+ */
+PersistentTree::NodePtr PersistentTree::Replace(const NodePtr& node,
+                                                KeyView key, ValuePtr value) {
+  if (key < node->key) {
+    return CopyNode(*node, Replace(node->left, key, std::move(value)),
+                    node->right);
+  }
+  if (key > node->key) {
+    return CopyNode(*node, node->left,
+                    Replace(node->right, key, std::move(value)));
+  }
+  return MakeNode(node->key, std::move(value), node->left, node->right);
+}
+
+/**
+ * @brief Rejects the write, a snapshot is read-only.
+ *
+ * @return false
+ */
+bool PersistentTree::Snapshot::Set(const Key&, const Value&) { return false; }
+
+/**
+ * @brief Retrieves the value associated with the specified key.
+ *
+ * @param key The key to retrieve.
+ * @return The value if the key is found, std::nullopt otherwise.
+ */
+std::optional<Value> PersistentTree::Snapshot::Get(KeyView key) const {
+  const Node* node = FindNode(root_, key);
+  if (node == nullptr) {
+    return std::nullopt;
+  }
+  return *node->value;
+}
+
+/**
+ * @brief Checks if a record with the given key exists.
+ *
+ * @param key The key to check.
+ * @return true if the key exists, false otherwise.
+ */
+bool PersistentTree::Snapshot::Exists(KeyView key) const {
+  return FindNode(root_, key) != nullptr;
+}
+
+/**
+ * @brief Rejects the write, a snapshot is read-only.
+ *
+ * @return false
+ */
+bool PersistentTree::Snapshot::Del(KeyView) { return false; }
+
+/**
+ * @brief Rejects the write, a snapshot is read-only.
+ *
+ * @return false
+ */
+bool PersistentTree::Snapshot::Update(const Key&, const std::string&) {
+  return false;
+}
+
+/**
+ * @brief Retrieves all keys in ascending order.
+ *
+ * @return A vector containing all keys.
+ */
+std::vector<Key> PersistentTree::Snapshot::Keys() const {
+  std::vector<Key> keys;
+  ForEach([&keys](const Node& node) { keys.push_back(node.key); });
+  return keys;
+}
+
+/**
+ * @brief Rejects the write, a snapshot is read-only.
+ *
+ * @return false
+ */
+bool PersistentTree::Snapshot::Rename(const Key&, const Key&) { return false; }
+
+/**
+ * @brief Returns the remaining time to live of the specified key.
+ *
+ * @param key The key to check.
+ * @return The TTL, or std::nullopt if the key is not found or has no TTL.
+ */
+std::optional<std::size_t> PersistentTree::Snapshot::TTL(KeyView key) const {
+  const Node* node = FindNode(root_, key);
+  if (node == nullptr) {
+    return std::nullopt;
+  }
+  return node->value->TTL();
+}
+
+/**
+ * @brief Finds the keys whose values match the given value.
+ *
+ * @param value The value to match, '-' matches any field.
+ * @return The matching keys in ascending order.
+ */
+std::vector<Key> PersistentTree::Snapshot::Find(
+    const std::string& value) const {
+  std::vector<Key> keys;
+  ForEach([&keys, &value](const Node& node) {
+    if (node.value->Match(value)) {
+      keys.push_back(node.key);
+    }
+  });
+  return keys;
+}
+
+/**
+ * @brief Retrieves all values in the order of their keys.
+ *
+ * @return A vector containing all values.
+ */
+std::vector<Value> PersistentTree::Snapshot::ShowAll() const {
+  std::vector<Value> values;
+  ForEach([&values](const Node& node) { values.push_back(*node.value); });
+  return values;
+}
+
+/**
+ * @brief Rejects the write, a snapshot is read-only.
+ *
+ * @throws std::logic_error Always.
+ */
+std::size_t PersistentTree::Snapshot::Upload(const std::string&) {
+  throw std::logic_error("Snapshot is read-only");
+}
+
+/**
+ * @brief Exports the records of the snapshot to a file.
+ *
+ * @param file_path The path to the file to export key-value pairs to.
+ * @return The number of records written to the file.
+ */
+std::size_t PersistentTree::Snapshot::Export(
+    const std::string& file_path) const {
+  std::ofstream file(file_path);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Invalid file_path");
+  }
+
+  std::size_t count = 0u;
+  ForEach([&](const Node& node) {
+    file << node.key << " " << node.value->ToQuotedString() << "\n";
+    ++count;
+  });
+
+  file.close();
+  return count;
+}
+
+/**
+ * @brief Does nothing, a snapshot is read-only.
+ */
+void PersistentTree::Snapshot::DeleteExpiredElements() {}
+
+/**
+ * @brief Returns up to count keys in ascending order, starting after the key
+ * stored in the cursor.
+ *
+ * @param cursor An empty string to start, or a cursor returned by Scan.
+ * @param count The maximum number of keys to return.
+ * @return The keys and the cursor of the next batch, empty at the end.
+ */
+AbstractStore::ScanResult PersistentTree::Snapshot::Scan(
+    const std::string& cursor, std::size_t count) const {
+  if (count == 0) count = 1;
+  std::optional<Key> after;
+  if (!cursor.empty()) after = ParseKeyCursor(cursor);
+
+  std::vector<const Node*> stack;
+  for (const Node* node = root_.get(); node != nullptr;) {
+    if (!after.has_value() or node->key > *after) {
+      stack.push_back(node);
+      node = node->left.get();
+    } else {
+      node = node->right.get();
+    }
+  }
+
+  ScanResult result;
+  while (!stack.empty() and result.keys.size() < count) {
+    const Node* node = stack.back();
+    stack.pop_back();
+    result.keys.push_back(node->key);
+    for (node = node->right.get(); node != nullptr; node = node->left.get()) {
+      stack.push_back(node);
+    }
+  }
+  if (!stack.empty()) {
+    result.cursor = KeyCursor(result.keys.back());
+  }
+  return result;
+}
+
+/**
+ * @brief Calls func for every node of the snapshot in key order.
+ */
+void PersistentTree::Snapshot::ForEach(
+    const std::function<void(const Node&)>& func) const {
+  std::vector<const Node*> stack;
+  const Node* node = root_.get();
+  while (node != nullptr or !stack.empty()) {
+    while (node != nullptr) {
+      stack.push_back(node);
+      node = node->left.get();
+    }
+    node = stack.back();
+    stack.pop_back();
+    func(*node);
+    node = node->right.get();
+  }
+}
+
+}  // namespace s21
@@ -0,0 +1,117 @@
+#ifndef TRANSACTIONS_PERSISTENT_TREE_PERSISTENT_TREE_H_
+#define TRANSACTIONS_PERSISTENT_TREE_PERSISTENT_TREE_H_
+
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "../common/abstract_store.h"
+
+namespace s21 {
+
+/**
+ * @brief Thread-safe AVL tree store whose versions share their nodes.
+ *
+ * Nodes never change once built. A write copies only the nodes on the path
+ * from the root to the changed key, rebalancing the copies, and shares every
+ * other subtree with the previous version; the new root is then published in
+ * one step. A snapshot is a copy of the root pointer, so it is taken in O(1)
+ * and keeps seeing the version it was taken from while the tree changes.
+ *
+ * Reads run on a snapshot and wait for writers only while a root pointer is
+ * copied, so a long Export or Find does not hold up writes. Writers are
+ * serialized among themselves. Upload, Rename and DeleteExpiredElements
+ * publish all of their changes at once.
+ */
+class PersistentTree : public AbstractStore {
+  struct Node;
+  using NodePtr = std::shared_ptr<const Node>;
+  using ValuePtr = std::shared_ptr<const Value>;
+
+ public:
+  /**
+   * @brief Read-only view of one version of a PersistentTree.
+   *
+   * Writes through the view are rejected: Set, Del, Update and Rename return
+   * false, Upload throws std::logic_error and DeleteExpiredElements does
+   * nothing.
+   */
+  class Snapshot : public AbstractStore {
+   public:
+    bool Set(const Key& key, const Value& value) override;
+    std::optional<Value> Get(KeyView key) const override;
+    bool Exists(KeyView key) const override;
+    bool Del(KeyView key) override;
+    bool Update(const Key& key, const std::string& new_value) override;
+    std::vector<Key> Keys() const override;
+    bool Rename(const Key& old_key, const Key& new_key) override;
+    std::optional<std::size_t> TTL(KeyView key) const override;
+    std::vector<Key> Find(const std::string& value) const override;
+    std::vector<Value> ShowAll() const override;
+    std::size_t Upload(const std::string& file_path) override;
+    std::size_t Export(const std::string& file_path) const override;
+    void DeleteExpiredElements() override;
+    ScanResult Scan(const std::string& cursor,
+                    std::size_t count) const override;
+    bool HasBoundedScan() const override { return true; }
+
+   private:
+    friend class PersistentTree;
+
+    explicit Snapshot(NodePtr root) : root_(std::move(root)) {}
+
+    void ForEach(const std::function<void(const Node&)>& func) const;
+
+    NodePtr root_;
+  };
+
+  Snapshot TakeSnapshot() const;
+
+  bool Set(const Key& key, const Value& value) override;
+  std::optional<Value> Get(KeyView key) const override;
+  bool Exists(KeyView key) const override;
+  bool Del(KeyView key) override;
+  bool Update(const Key& key, const std::string& new_value) override;
+  std::vector<Key> Keys() const override;
+  bool Rename(const Key& old_key, const Key& new_key) override;
+  std::optional<std::size_t> TTL(KeyView key) const override;
+  std::vector<Key> Find(const std::string& value) const override;
+  std::vector<Value> ShowAll() const override;
+  std::size_t Upload(const std::string& file_path) override;
+  std::size_t Export(const std::string& file_path) const override;
+  void DeleteExpiredElements() override;
+  ScanResult Scan(const std::string& cursor, std::size_t count) const override;
+  bool HasBoundedScan() const override { return true; }
+
+ private:
+  struct Node {
+    Key key;
+    ValuePtr value;
+    NodePtr left;
+    NodePtr right;
+    int height;
+  };
+
+  mutable std::mutex root_mutex_;
+  std::mutex write_mutex_;
+  NodePtr root_;
+
+  NodePtr Root() const;
+  void Publish(NodePtr root);
+
+  static const Node* FindNode(const NodePtr& root, KeyView key);
+  static int Height(const NodePtr& node);
+  static NodePtr MakeNode(const Key& key, ValuePtr value, NodePtr left,
+                          NodePtr right);
+  static NodePtr CopyNode(const Node& node, NodePtr left, NodePtr right);
+  static NodePtr Balance(const Node& node, NodePtr left, NodePtr right);
+  static NodePtr Insert(const NodePtr& node, const Key& key, ValuePtr value);
+  static NodePtr Erase(const NodePtr& node, KeyView key);
+  static NodePtr EraseMin(const NodePtr& node, const Node*& min);
+  static NodePtr Replace(const NodePtr& node, KeyView key, ValuePtr value);
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_PERSISTENT_TREE_PERSISTENT_TREE_H_
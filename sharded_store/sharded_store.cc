@@ -0,0 +1,374 @@
+#include "sharded_store.h"
+
+#include <algorithm>
+
+#include "../hash_table/hash_functions.h"
+#include "../hash_table/hash_table.h"
+
+namespace s21 {
+
+/**
+ * @brief Constructs a sharded store and starts one worker per shard.
+ *
+ * Every inner store is built before any worker starts. If a worker cannot be
+ * started, the ones already running are stopped and the exception is
+ * rethrown.
+ *
+ * @param shards The number of shards. Zero is treated as one.
+ * @param factory Creates the inner store of each shard. A HashTable is used
+ * when no factory is given.
+ */
+ShardedStore::ShardedStore(std::size_t shards, StoreFactory factory) {
+  if (shards == 0) shards = 1;
+  if (!factory) {
+    factory = [] { return std::make_unique<HashTable>(); };
+  }
+  shards_.reserve(shards);
+  for (std::size_t i = 0; i < shards; ++i) {
+    auto shard = std::make_unique<Shard>();
+    shard->store = factory();
+    shards_.push_back(std::move(shard));
+  }
+  try {
+    for (auto& shard : shards_) {
+      shard->worker = std::thread(WorkerLoop, std::ref(*shard));
+    }
+  } catch (...) {
+    StopWorkers();
+    throw;
+  }
+}
+
+/**
+ * @brief Stops the workers once they have drained their queues.
+ */
+ShardedStore::~ShardedStore() { StopWorkers(); }
+
+/**
+ * @brief Asks every running worker to stop and waits for it to finish.
+ */
+void ShardedStore::StopWorkers() {
+  for (auto& shard : shards_) {
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      shard->stop = true;
+    }
+    shard->ready.notify_one();
+  }
+  for (auto& shard : shards_) {
+    if (shard->worker.joinable()) shard->worker.join();
+  }
+}
+
+/**
+ * @brief Sets the value for the specified key in its shard.
+ *
+ * @param key The key to set.
+ * @param value The value associated with the key.
+ * @return true if the record was inserted, false if the key already exists.
+ */
+bool ShardedStore::Set(const Key& key, const Value& value) {
+  return Submit(ShardOf(key), [&](AbstractStore& store) {
+           return store.Set(key, value);
+         }).get();
+}
+
+/**
+ * @brief Retrieves the value associated with the specified key.
+ *
+ * @param key The key to retrieve.
+ * @return The value if the key is found, std::nullopt otherwise.
+ */
+std::optional<Value> ShardedStore::Get(KeyView key) const {
+  return Submit(ShardOf(key),
+                [key](AbstractStore& store) { return store.Get(key); })
+      .get();
+}
+
+/**
+ * @brief Checks if a record with the given key exists.
+ *
+ * @param key The key to check.
+ * @return true if the key exists, false otherwise.
+ */
+bool ShardedStore::Exists(KeyView key) const {
+  return Submit(ShardOf(key),
+                [key](AbstractStore& store) { return store.Exists(key); })
+      .get();
+}
+
+/**
+ * @brief Deletes the record with the specified key.
+ *
+ * @param key The key to delete.
+ * @return true if the record was deleted, false if the key does not exist.
+ */
+bool ShardedStore::Del(KeyView key) {
+  return Submit(ShardOf(key),
+                [key](AbstractStore& store) { return store.Del(key); })
+      .get();
+}
+
+/**
+ * @brief Updates the value associated with the specified key.
+ *
+ * @param key The key to update.
+ * @param new_value The new value; '-' fields are left unchanged.
+ * @return true if the value was updated, false if the key does not exist.
+ */
+bool ShardedStore::Update(const Key& key, const std::string& new_value) {
+  return Submit(ShardOf(key), [&](AbstractStore& store) {
+           return store.Update(key, new_value);
+         }).get();
+}
+
+/**
+ * @brief Retrieves the keys of all shards.
+ *
+ * @return A vector with all the keys, grouped by shard.
+ */
+std::vector<Key> ShardedStore::Keys() const {
+  std::vector<Key> keys;
+  for (auto& part : Broadcast([](AbstractStore& store) {
+         return store.Keys();
+       })) {
+    std::move(part.begin(), part.end(), std::back_inserter(keys));
+  }
+  return keys;
+}
+
+/**
+ * @brief Renames a key.
+ *
+ * When both keys live in the same shard the inner store renames the key
+ * itself. Otherwise the rename is not atomic: the record is first copied to
+ * the new key, which fails if the new key exists, and only then removed from
+ * the old shard, so the record is never missing from both shards. If the old
+ * record was deleted or changed by another client in between, the copy is
+ * removed again and the rename fails.
+ *
+ * @param old_key The key to rename.
+ * @param new_key The new name of the key.
+ * @return true if the key was renamed, false otherwise.
+ */
+bool ShardedStore::Rename(const Key& old_key, const Key& new_key) {
+  std::size_t old_shard = ShardOf(old_key);
+  std::size_t new_shard = ShardOf(new_key);
+  if (old_shard == new_shard) {
+    return Submit(old_shard, [&](AbstractStore& store) {
+             return store.Rename(old_key, new_key);
+           }).get();
+  }
+
+  std::optional<Value> value = Get(old_key);
+  if (!value.has_value() or !Set(new_key, *value)) {
+    return false;
+  }
+  bool removed = Submit(old_shard, [&](AbstractStore& store) {
+                   return store.Get(old_key) == value and store.Del(old_key);
+                 }).get();
+  if (!removed) {
+    Del(new_key);
+  }
+  return removed;
+}
+
+/**
+ * @brief Retrieves the remaining time to live of the specified key.
+ *
+ * @param key The key to look up.
+ * @return The TTL in seconds, or std::nullopt if the key does not exist or has
+ * no expiration.
+ */
+std::optional<std::size_t> ShardedStore::TTL(KeyView key) const {
+  return Submit(ShardOf(key),
+                [key](AbstractStore& store) { return store.TTL(key); })
+      .get();
+}
+
+/**
+ * @brief Finds the keys of all records matching the given value, searching
+ * every shard in parallel.
+ *
+ * @param value The value to match; '-' fields match anything.
+ * @return A vector with the matching keys.
+ */
+std::vector<Key> ShardedStore::Find(const std::string& value) const {
+  std::vector<Key> keys;
+  for (auto& part : Broadcast([&value](AbstractStore& store) {
+         return store.Find(value);
+       })) {
+    std::move(part.begin(), part.end(), std::back_inserter(keys));
+  }
+  return keys;
+}
+
+/**
+ * @brief Retrieves the values of all shards.
+ *
+ * @return A vector with all the values, in the same order as Keys.
+ */
+std::vector<Value> ShardedStore::ShowAll() const {
+  std::vector<Value> values;
+  for (auto& part : Broadcast([](AbstractStore& store) {
+         return store.ShowAll();
+       })) {
+    std::move(part.begin(), part.end(), std::back_inserter(values));
+  }
+  return values;
+}
+
+/**
+ * @brief Uploads records from a file.
+ *
+ * The file is parsed by the caller and the records are handed to every shard
+ * as a single batch, so the shards insert them in parallel.
+ *
+ * @param file_path The path of the file to read.
+ * @return The number of records read from the file.
+ */
+std::size_t ShardedStore::Upload(const std::string& file_path) {
+  std::ifstream file(file_path);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Invalid file_path");
+  }
+
+  std::vector<std::vector<std::pair<Key, Value>>> batches(shards_.size());
+  Key key;
+  std::string value;
+
+  std::size_t count = 0u;
+  while (file >> key) {
+    std::getline(file >> std::ws, value);
+    batches[ShardOf(key)].emplace_back(key, Value::FromString(value));
+    ++count;
+  }
+  file.close();
+
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 0; i < shards_.size(); ++i) {
+    futures.push_back(Submit(i, [&batch = batches[i]](AbstractStore& store) {
+      for (const auto& [batch_key, batch_value] : batch) {
+        store.Set(batch_key, batch_value);
+      }
+    }));
+  }
+  for (std::future<void>& future : futures) {
+    future.get();
+  }
+  return count;
+}
+
+/**
+ * @brief Exports the records of all shards to a file.
+ *
+ * @param file_path The path of the file to write.
+ * @return The number of exported records.
+ */
+std::size_t ShardedStore::Export(const std::string& file_path) const {
+  std::ofstream file(file_path);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Invalid file_path");
+  }
+
+  // Keys and values of a shard are read in one task, so they always match.
+  auto parts = Broadcast([](AbstractStore& store) {
+    return std::make_pair(store.Keys(), store.ShowAll());
+  });
+
+  std::size_t count = 0u;
+  for (const auto& [keys, values] : parts) {
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      file << keys[i] << " " << values[i].ToQuotedString() << "\n";
+      ++count;
+    }
+  }
+
+  file.close();
+  return count;
+}
+
+/**
+ * @brief Deletes the expired records of all shards in parallel.
+ */
+void ShardedStore::DeleteExpiredElements() {
+  Broadcast([](AbstractStore& store) {
+    store.DeleteExpiredElements();
+    return true;
+  });
+}
+
+/**
+ * @brief Retrieves the values of several keys.
+ *
+ * The keys are grouped by shard and each shard resolves its group with a
+ * single batched MGet of its inner store, so the shards work in parallel.
+ *
+ * @param keys The keys to retrieve.
+ * @return The values in the order of the keys; std::nullopt for missing keys.
+ */
+std::vector<std::optional<Value>> ShardedStore::MGet(
+    const std::vector<Key>& keys) const {
+  std::vector<std::vector<Key>> groups(shards_.size());
+  std::vector<std::vector<std::size_t>> positions(shards_.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    std::size_t shard = ShardOf(keys[i]);
+    groups[shard].push_back(keys[i]);
+    positions[shard].push_back(i);
+  }
+
+  std::vector<std::future<std::vector<std::optional<Value>>>> futures;
+  for (std::size_t i = 0; i < shards_.size(); ++i) {
+    futures.push_back(Submit(i, [&group = groups[i]](AbstractStore& store) {
+      return store.MGet(group);
+    }));
+  }
+
+  std::vector<std::optional<Value>> values(keys.size());
+  for (std::size_t i = 0; i < shards_.size(); ++i) {
+    std::vector<std::optional<Value>> part = futures[i].get();
+    for (std::size_t j = 0; j < part.size(); ++j) {
+      values[positions[i][j]] = std::move(part[j]);
+    }
+  }
+  return values;
+}
+
+/**
+ * @brief Returns the index of the shard that owns the key.
+ *
+ * The hash uses its own seed, so the shard of a key is independent of the
+ * bucket the inner hash table puts it in.
+ */
+std::size_t ShardedStore::ShardOf(KeyView key) const {
+  return FastRange(WyHash(key, kShardSeed), shards_.size());
+}
+
+/**
+ * @brief Returns the default number of shards: one per hardware thread.
+ */
+std::size_t ShardedStore::DefaultShards() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Executes the queued operations of a shard until it is stopped.
+ *
+ * @param shard The shard served by the calling thread.
+ */
+void ShardedStore::WorkerLoop(Shard& shard) {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(shard.mutex);
+      shard.ready.wait(lock,
+                       [&shard] { return shard.stop or !shard.queue.empty(); });
+      if (shard.queue.empty()) return;
+      task = std::move(shard.queue.front());
+      shard.queue.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace s21
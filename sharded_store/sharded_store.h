@@ -0,0 +1,127 @@
+#ifndef TRANSACTIONS_SHARDED_STORE_SHARDED_STORE_H_
+#define TRANSACTIONS_SHARDED_STORE_SHARDED_STORE_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "../common/abstract_store.h"
+
+namespace s21 {
+
+/**
+ * @brief Shared-nothing key-value store that partitions keys across shards.
+ *
+ * Every key belongs to exactly one shard, selected by a seeded wyhash of the
+ * key. A shard owns an independent inner store (a HashTable by default) and a
+ * worker thread that executes the operations queued for that shard one at a
+ * time, so the inner stores are never touched by two threads and need no
+ * locks of their own. Single-key operations are forwarded to the owning shard
+ * and the caller waits for the result; Keys, ShowAll, Find, Export and
+ * DeleteExpiredElements are sent to all shards at once and their results are
+ * merged once every shard has answered. Records are not ordered across shards.
+ */
+class ShardedStore : public AbstractStore {
+ public:
+  using StoreFactory = std::function<std::unique_ptr<AbstractStore>()>;
+
+  explicit ShardedStore(std::size_t shards = DefaultShards(),
+                        StoreFactory factory = nullptr);
+  ShardedStore(const ShardedStore&) = delete;
+  ShardedStore& operator=(const ShardedStore&) = delete;
+  ~ShardedStore() override;
+
+  bool Set(const Key& key, const Value& value) override;
+  std::optional<Value> Get(KeyView key) const override;
+  bool Exists(KeyView key) const override;
+  bool Del(KeyView key) override;
+  bool Update(const Key& key, const std::string& new_value) override;
+  std::vector<Key> Keys() const override;
+  bool Rename(const Key& old_key, const Key& new_key) override;
+  std::optional<std::size_t> TTL(KeyView key) const override;
+  std::vector<Key> Find(const std::string& value) const override;
+  std::vector<Value> ShowAll() const override;
+  std::size_t Upload(const std::string& file_path) override;
+  std::size_t Export(const std::string& file_path) const override;
+  void DeleteExpiredElements() override;
+  std::vector<std::optional<Value>> MGet(
+      const std::vector<Key>& keys) const override;
+
+  std::size_t Shards() const { return shards_.size(); }
+  std::size_t ShardOf(KeyView key) const;
+
+  static std::size_t DefaultShards();
+
+ private:
+  struct Shard {
+    std::unique_ptr<AbstractStore> store;
+    std::deque<std::function<void()>> queue;
+    std::mutex mutex;
+    std::condition_variable ready;
+    bool stop = false;
+    std::thread worker;
+  };
+
+  static constexpr std::uint64_t kShardSeed = 0x5eed5eed5eed5eedull;
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  void StopWorkers();
+  static void WorkerLoop(Shard& shard);
+
+  /**
+   * @brief Queues a call of func on the inner store of the given shard.
+   *
+   * The call runs on the worker thread of the shard. Exceptions thrown by func
+   * are delivered through the returned future.
+   */
+  template <typename Func>
+  auto Submit(std::size_t index, Func func) const
+      -> std::future<std::invoke_result_t<Func, AbstractStore&>> {
+    using Result = std::invoke_result_t<Func, AbstractStore&>;
+    Shard& shard = *shards_[index];
+    auto task = std::make_shared<std::packaged_task<Result()>>(
+        [&shard, func = std::move(func)]() mutable {
+          return func(*shard.store);
+        });
+    std::future<Result> result = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.queue.emplace_back([task] { (*task)(); });
+    }
+    shard.ready.notify_one();
+    return result;
+  }
+
+  /**
+   * @brief Runs func on every shard in parallel and collects the results in
+   * shard order.
+   */
+  template <typename Func>
+  auto Broadcast(Func func) const
+      -> std::vector<std::invoke_result_t<Func, AbstractStore&>> {
+    using Result = std::invoke_result_t<Func, AbstractStore&>;
+    std::vector<std::future<Result>> futures;
+    futures.reserve(shards_.size());
+    for (std::size_t i = 0; i < shards_.size(); ++i) {
+      futures.push_back(Submit(i, func));
+    }
+    std::vector<Result> results;
+    results.reserve(futures.size());
+    for (std::future<Result>& future : futures) {
+      results.push_back(future.get());
+    }
+    return results;
+  }
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SHARDED_STORE_SHARDED_STORE_H_
@@ -0,0 +1,423 @@
+#include "swiss_table.h"
+
+namespace s21 {
+
+/**
+ * @brief Loads the control bytes of a group starting at the given position.
+ *
+ * @param ctrl Pointer to the first control byte of the group.
+ */
+#if defined(__SSE2__)
+SwissTable::Group::Group(const Control* ctrl)
+    : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+#else
+SwissTable::Group::Group(const Control* ctrl) : ctrl_(ctrl) {}
+#endif
+
+/**
+ * @brief Finds the slots of the group whose control byte equals the tag.
+ *
+ * @param tag The 7-bit hash tag to look for.
+ * @return A bit mask of the matching slots.
+ */
+std::uint32_t SwissTable::Group::Match(Control tag) const {
+#if defined(__SSE2__)
+  return static_cast<std::uint32_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), ctrl_)));
+#else
+  std::uint32_t mask = 0;
+  for (std::size_t i = 0; i < kGroupWidth; ++i) {
+    if (ctrl_[i] == tag) mask |= 1u << i;
+  }
+  return mask;
+#endif
+}
+
+/**
+ * @brief Finds the empty slots of the group.
+ *
+ * @return A bit mask of the empty slots.
+ */
+std::uint32_t SwissTable::Group::MatchEmpty() const { return Match(kEmpty); }
+
+/**
+ * @brief Finds the slots of the group that can receive a new record.
+ *
+ * Both empty and deleted markers have the sign bit set, while the control byte
+ * of a full slot is a non-negative 7-bit tag.
+ *
+ * @return A bit mask of the empty or deleted slots.
+ */
+std::uint32_t SwissTable::Group::MatchEmptyOrDeleted() const {
+#if defined(__SSE2__)
+  return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl_));
+#else
+  std::uint32_t mask = 0;
+  for (std::size_t i = 0; i < kGroupWidth; ++i) {
+    if (ctrl_[i] < 0) mask |= 1u << i;
+  }
+  return mask;
+#endif
+}
+
+/**
+ * @brief Constructs an empty Swiss table.
+ *
+ * @param capacity The initial number of slots. It is rounded up to a power of
+ * two and is never less than kMinCapacity.
+ */
+SwissTable::SwissTable(std::size_t capacity)
+    : capacity_(kMinCapacity), size_(0), deleted_(0) {
+  while (capacity_ < capacity) capacity_ *= 2;
+  ctrl_.assign(capacity_, kEmpty);
+  slots_.resize(capacity_);
+}
+
+/**
+ * @brief Sets the value for the specified key.
+ *
+ * @param key The key to set.
+ * @param value The value associated with the key.
+ * @return true if the record was inserted, false if the key already exists.
+ */
+bool SwissTable::Set(const Key& key, const Value& value) {
+  if (FindSlot(key) != kNotFound) {
+    return false;
+  }
+  InsertSlot(key, value);
+  return true;
+}
+
+/**
+ * @brief Retrieves the value associated with the specified key.
+ *
+ * @param key The key to retrieve.
+ * @return The value if the key is found, std::nullopt otherwise.
+ */
+std::optional<Value> SwissTable::Get(KeyView key) const {
+  std::size_t index = FindSlot(key);
+  if (index == kNotFound) {
+    return std::nullopt;
+  }
+  return slots_[index].value;
+}
+
+/**
+ * @brief Checks if a record with the given key exists.
+ *
+ * @param key The key to check.
+ * @return true if the key exists, false otherwise.
+ */
+bool SwissTable::Exists(KeyView key) const {
+  return FindSlot(key) != kNotFound;
+}
+
+/**
+ * @brief Deletes the record with the specified key.
+ *
+ * @param key The key to delete.
+ * @return true if the record was deleted, false if the key does not exist.
+ */
+bool SwissTable::Del(KeyView key) {
+  std::size_t index = FindSlot(key);
+  if (index == kNotFound) {
+    return false;
+  }
+  EraseSlot(index);
+  return true;
+}
+
+/**
+ * @brief Updates the value associated with the specified key.
+ *
+ * @param key The key to update.
+ * @param new_value The new value fields, '-' keeps a field unchanged.
+ * @return true if the value was updated, false if the key does not exist.
+ */
+bool SwissTable::Update(const Key& key, const std::string& new_value) {
+  std::size_t index = FindSlot(key);
+  if (index == kNotFound) {
+    return false;
+  }
+  slots_[index].value.Update(new_value);
+  return true;
+}
+
+/**
+ * @brief Retrieves all the keys stored in the table.
+ *
+ * @return A vector containing all the keys.
+ */
+std::vector<Key> SwissTable::Keys() const {
+  std::vector<Key> keys;
+  keys.reserve(size_);
+  ForEach([&keys](const Slot& slot) { keys.push_back(slot.key); });
+  return keys;
+}
+
+/**
+ * @brief Renames a key in the table.
+ *
+ * @param old_key The key to rename.
+ * @param new_key The new name of the key.
+ * @return true if the key was renamed, false if the old key does not exist or
+ * the new key is already taken.
+ */
+bool SwissTable::Rename(const Key& old_key, const Key& new_key) {
+  std::size_t index = FindSlot(old_key);
+  if (index == kNotFound or FindSlot(new_key) != kNotFound) {
+    return false;
+  }
+  Value value = std::move(slots_[index].value);
+  EraseSlot(index);
+  InsertSlot(new_key, std::move(value));
+  return true;
+}
+
+/**
+ * @brief Retrieves the time-to-live of a key.
+ *
+ * @param key The key to retrieve TTL for.
+ * @return The remaining seconds, or std::nullopt if the key does not exist or
+ * has no TTL.
+ */
+std::optional<std::size_t> SwissTable::TTL(KeyView key) const {
+  std::size_t index = FindSlot(key);
+  if (index == kNotFound) {
+    return std::nullopt;
+  }
+  return slots_[index].value.TTL();
+}
+
+/**
+ * @brief Finds all keys whose value matches the given pattern.
+ *
+ * @param value The value pattern, '-' matches any field.
+ * @return A vector containing the matching keys.
+ */
+std::vector<Key> SwissTable::Find(const std::string& value) const {
+  std::vector<Key> keys;
+  ForEach([&](const Slot& slot) {
+    if (slot.value.Match(value)) {
+      keys.push_back(slot.key);
+    }
+  });
+  return keys;
+}
+
+/**
+ * @brief Retrieves all the values stored in the table.
+ *
+ * @return A vector containing all the values.
+ */
+std::vector<Value> SwissTable::ShowAll() const {
+  std::vector<Value> values;
+  values.reserve(size_);
+  ForEach([&values](const Slot& slot) { values.push_back(slot.value); });
+  return values;
+}
+
+/**
+ * @brief Uploads key-value pairs from a file.
+ *
+ * @param file_path The path to the file containing key-value pairs.
+ * @return The number of records read from the file.
+ */
+std::size_t SwissTable::Upload(const std::string& file_path) {
+  std::ifstream file(file_path);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Invalid file_path");
+  }
+
+  Key key;
+  std::string value;
+
+  std::size_t count = 0u;
+  while (file >> key) {
+    std::getline(file >> std::ws, value);
+    Set(key, Value::FromString(value));
+    ++count;
+  }
+
+  file.close();
+  return count;
+}
+
+/**
+ * @brief Exports key-value pairs to a file.
+ *
+ * @param file_path The path to the file to export key-value pairs to.
+ * @return The number of records written to the file.
+ */
+std::size_t SwissTable::Export(const std::string& file_path) const {
+  std::ofstream file(file_path);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Invalid file_path");
+  }
+
+  std::size_t count = 0u;
+  ForEach([&](const Slot& slot) {
+    file << slot.key << " " << slot.value.ToQuotedString() << "\n";
+    ++count;
+  });
+
+  file.close();
+  return count;
+}
+
+/**
+ * @brief Deletes expired elements from the table.
+ */
+void SwissTable::DeleteExpiredElements() {
+  for (std::size_t i = 0; i < capacity_; ++i) {
+    if (IsFull(ctrl_[i]) and slots_[i].value.TTL() == 0u) {
+      EraseSlot(i);
+    }
+  }
+}
+
+std::size_t SwissTable::HashFunction(KeyView key) {
+  return std::hash<KeyView>{}(key);
+}
+
+/**
+ * @brief Extracts the 7-bit tag stored in the control byte of a full slot.
+ */
+SwissTable::Control SwissTable::Tag(std::size_t hash) {
+  return static_cast<Control>(hash & 0x7f);
+}
+
+bool SwissTable::IsFull(Control ctrl) { return ctrl >= 0; }
+
+std::size_t SwissTable::GroupMask() const {
+  return capacity_ / kGroupWidth - 1;
+}
+
+/**
+ * @brief Finds the slot holding the given key.
+ *
+ * Groups are visited in triangular order starting from the group selected by
+ * the upper hash bits. Probing stops at the first group with an empty slot,
+ * because an insertion would never have skipped it.
+ *
+ * @param key The key to look for.
+ * @return The slot index, or kNotFound if the key is absent.
+ */
+std::size_t SwissTable::FindSlot(KeyView key) const {
+  std::size_t hash = HashFunction(key);
+  Control tag = Tag(hash);
+  std::size_t group = (hash >> 7) & GroupMask();
+  for (std::size_t step = 1;; ++step) {
+    Group ctrl(&ctrl_[group * kGroupWidth]);
+    for (std::uint32_t mask = ctrl.Match(tag); mask != 0; mask &= mask - 1) {
+      std::size_t index = group * kGroupWidth + __builtin_ctz(mask);
+      if (slots_[index].key == key) {
+        return index;
+      }
+    }
+    if (ctrl.MatchEmpty() != 0) {
+      return kNotFound;
+    }
+    group = (group + step) & GroupMask();
+  }
+}
+
+/**
+ * @brief Finds the first empty or deleted slot on the probe sequence of the
+ * given hash.
+ *
+ * @param hash The full hash of the key being inserted.
+ * @return The index of a free slot.
+ */
+std::size_t SwissTable::FindInsertSlot(std::size_t hash) const {
+  std::size_t group = (hash >> 7) & GroupMask();
+  for (std::size_t step = 1;; ++step) {
+    std::uint32_t mask =
+        Group(&ctrl_[group * kGroupWidth]).MatchEmptyOrDeleted();
+    if (mask != 0) {
+      return group * kGroupWidth + __builtin_ctz(mask);
+    }
+    group = (group + step) & GroupMask();
+  }
+}
+
+/**
+ * @brief Inserts a record whose key is known to be absent.
+ *
+ * The table keeps at most 7/8 of its slots non-empty. When the limit is hit,
+ * it either doubles or, if most of the used slots are tombstones, is rebuilt
+ * in place at the same capacity.
+ *
+ * @param key The key to insert.
+ * @param value The value to insert.
+ */
+void SwissTable::InsertSlot(Key key, Value value) {
+  if ((size_ + deleted_ + 1) * 8 > capacity_ * 7) {
+    Rehash((size_ + 1) * 16 > capacity_ * 7 ? capacity_ * 2 : capacity_);
+  }
+  std::size_t hash = HashFunction(key);
+  std::size_t index = FindInsertSlot(hash);
+  if (ctrl_[index] == kDeleted) --deleted_;
+  ctrl_[index] = Tag(hash);
+  slots_[index].key = std::move(key);
+  slots_[index].value = std::move(value);
+  ++size_;
+}
+
+/**
+ * @brief Removes the record stored in the given slot.
+ *
+ * If the group of the slot still has an empty slot, no probe sequence could
+ * have passed through it, so the slot becomes empty again. Otherwise it is
+ * marked as deleted to keep the probe sequences of other keys intact.
+ *
+ * @param index The index of a full slot.
+ */
+void SwissTable::EraseSlot(std::size_t index) {
+  std::size_t group = index / kGroupWidth;
+  if (Group(&ctrl_[group * kGroupWidth]).MatchEmpty() != 0) {
+    ctrl_[index] = kEmpty;
+  } else {
+    ctrl_[index] = kDeleted;
+    ++deleted_;
+  }
+  slots_[index] = Slot();
+  --size_;
+}
+
+/**
+ * @brief Moves all the records into freshly allocated arrays.
+ *
+ * @param new_capacity The number of slots of the new arrays.
+ */
+void SwissTable::Rehash(std::size_t new_capacity) {
+  std::vector<Control> old_ctrl = std::move(ctrl_);
+  std::vector<Slot> old_slots = std::move(slots_);
+
+  capacity_ = new_capacity;
+  size_ = 0;
+  deleted_ = 0;
+  ctrl_.assign(capacity_, kEmpty);
+  slots_.clear();
+  slots_.resize(capacity_);
+
+  for (std::size_t i = 0; i < old_ctrl.size(); ++i) {
+    if (IsFull(old_ctrl[i])) {
+      std::size_t hash = HashFunction(old_slots[i].key);
+      std::size_t index = FindInsertSlot(hash);
+      ctrl_[index] = Tag(hash);
+      slots_[index] = std::move(old_slots[i]);
+      ++size_;
+    }
+  }
+}
+
+void SwissTable::ForEach(const std::function<void(const Slot&)>& func) const {
+  for (std::size_t i = 0; i < capacity_; ++i) {
+    if (IsFull(ctrl_[i])) {
+      func(slots_[i]);
+    }
+  }
+}
+
+}  // namespace s21
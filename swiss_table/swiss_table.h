@@ -0,0 +1,102 @@
+#ifndef TRANSACTIONS_SWISS_TABLE_SWISS_TABLE_H_
+#define TRANSACTIONS_SWISS_TABLE_SWISS_TABLE_H_
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+
+#include "../common/abstract_store.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace s21 {
+
+/**
+ * @brief In-memory key-value store based on an open-addressing Swiss table.
+ *
+ * Records live in a flat array of slots. Every slot has a one-byte control
+ * word holding either a marker (empty / deleted) or the low 7 bits of the key
+ * hash. Slots are probed in groups of 16: the control bytes of a whole group
+ * are compared against the hash tag at once (with SSE2 when available), so a
+ * lookup touches the key strings only for slots whose tag already matched.
+ */
+class SwissTable : public AbstractStore {
+ public:
+  explicit SwissTable(std::size_t capacity = kMinCapacity);
+
+  bool Set(const Key& key, const Value& value) override;
+  std::optional<Value> Get(KeyView key) const override;
+  bool Exists(KeyView key) const override;
+  bool Del(KeyView key) override;
+  bool Update(const Key& key, const std::string& new_value) override;
+  std::vector<Key> Keys() const override;
+  bool Rename(const Key& old_key, const Key& new_key) override;
+  std::optional<std::size_t> TTL(KeyView key) const override;
+  std::vector<Key> Find(const std::string& value) const override;
+  std::vector<Value> ShowAll() const override;
+  std::size_t Upload(const std::string& file_path) override;
+  std::size_t Export(const std::string& file_path) const override;
+  void DeleteExpiredElements() override;
+
+  std::size_t Size() const { return size_; }
+  std::size_t Capacity() const { return capacity_; }
+
+ private:
+  using Control = std::int8_t;
+
+  struct Slot {
+    Key key;
+    Value value;
+  };
+
+  /**
+   * @brief A view over the control bytes of one probing group.
+   *
+   * Each Match* method returns a bit mask where bit i is set if the i-th slot
+   * of the group satisfies the condition.
+   */
+  class Group {
+   public:
+    explicit Group(const Control* ctrl);
+
+    std::uint32_t Match(Control tag) const;
+    std::uint32_t MatchEmpty() const;
+    std::uint32_t MatchEmptyOrDeleted() const;
+
+   private:
+#if defined(__SSE2__)
+    __m128i ctrl_;
+#else
+    const Control* ctrl_;
+#endif
+  };
+
+  static constexpr Control kEmpty = -128;
+  static constexpr Control kDeleted = -2;
+  static constexpr std::size_t kGroupWidth = 16;
+  static constexpr std::size_t kMinCapacity = 256;
+  static constexpr std::size_t kNotFound = static_cast<std::size_t>(-1);
+
+  std::size_t capacity_;
+  std::size_t size_;
+  std::size_t deleted_;
+  std::vector<Control> ctrl_;
+  std::vector<Slot> slots_;
+
+  static std::size_t HashFunction(KeyView key);
+  static Control Tag(std::size_t hash);
+  static bool IsFull(Control ctrl);
+  std::size_t GroupMask() const;
+  std::size_t FindSlot(KeyView key) const;
+  std::size_t FindInsertSlot(std::size_t hash) const;
+  void InsertSlot(Key key, Value value);
+  void EraseSlot(std::size_t index);
+  void Rehash(std::size_t new_capacity);
+  void ForEach(const std::function<void(const Slot&)>& func) const;
+};
+
+}  // namespace s21
+
+#endif  // TRANSACTIONS_SWISS_TABLE_SWISS_TABLE_H_
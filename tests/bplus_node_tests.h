@@ -5,160 +5,164 @@
 using namespace s21;
 
 TEST(BPlusNodeTest, Constructor) {
-  auto node = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  EXPECT_TRUE(node->IsLeaf());
-  EXPECT_EQ(node->Size(), 0);
-  EXPECT_FALSE(node->Exists("test_key"));
+  BPlusNode node(BPlusNode::NodeType::kLeaf);
+  EXPECT_TRUE(node.IsLeaf());
+  EXPECT_EQ(node.Size(), 0);
+  EXPECT_FALSE(node.Exists("test_key"));
 }
 
 TEST(BPlusNodeTest, IsLeaf) {
-  auto leaf = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  auto internal = std::make_shared<BPlusNode>(BPlusNode::NodeType::kInternal);
-  EXPECT_TRUE(leaf->IsLeaf());
-  EXPECT_FALSE(internal->IsLeaf());
+  BPlusNode leaf(BPlusNode::NodeType::kLeaf);
+  BPlusNode internal(BPlusNode::NodeType::kInternal);
+  EXPECT_TRUE(leaf.IsLeaf());
+  EXPECT_FALSE(internal.IsLeaf());
 }
 
 TEST(BPlusNodeTest, Size) {
-  auto node = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  EXPECT_EQ(node->Size(), 0u);
+  BPlusNode node(BPlusNode::NodeType::kLeaf);
+  EXPECT_EQ(node.Size(), 0u);
 
   Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
   Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
   Value value3("Sidorov", "Sergei", "1980", "Novosibirsk", "50");
 
-  node->Insert("key1", value1);
-  EXPECT_EQ(node->Size(), 1u);
+  node.Insert("key1", value1);
+  EXPECT_EQ(node.Size(), 1u);
 
-  node->Insert("key2", value2);
-  EXPECT_EQ(node->Size(), 2u);
+  node.Insert("key2", value2);
+  EXPECT_EQ(node.Size(), 2u);
 
-  node->Insert("key3", value3);
-  EXPECT_EQ(node->Size(), 3u);
+  node.Insert("key3", value3);
+  EXPECT_EQ(node.Size(), 3u);
 
-  node->Remove("key2");
-  EXPECT_EQ(node->Size(), 2u);
+  node.Remove("key2");
+  EXPECT_EQ(node.Size(), 2u);
 }
 
 TEST(BPlusNodeTest, InsertInternal) {
-  auto node = std::make_shared<BPlusNode>(BPlusNode::NodeType::kInternal);
-  auto child1 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  auto child2 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-
-  node->Insert("key1", child1, false);
-  node->Insert("key2", child2, false);
-  node->Insert("key3", child2, false);
-
-  EXPECT_EQ(node->Size(), 3u);
-  EXPECT_TRUE(node->Exists("key1"));
-  EXPECT_TRUE(node->Exists("key2"));
-  EXPECT_TRUE(node->Exists("key3"));
+  BPlusNode node(BPlusNode::NodeType::kInternal);
+  BPlusNode child1(BPlusNode::NodeType::kLeaf);
+  BPlusNode child2(BPlusNode::NodeType::kLeaf);
+
+  node.Insert("key1", &child1, false);
+  node.Insert("key2", &child2, false);
+  node.Insert("key3", &child2, false);
+
+  EXPECT_EQ(node.Size(), 3u);
+  EXPECT_TRUE(node.Exists("key1"));
+  EXPECT_TRUE(node.Exists("key2"));
+  EXPECT_TRUE(node.Exists("key3"));
 }
 
 TEST(BPlusNodeTest, InsertLeaf) {
-  auto node = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
+  BPlusNode node(BPlusNode::NodeType::kLeaf);
   Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
 
-  bool success = node->Insert("foo", value1);
+  bool success = node.Insert("foo", value1);
   EXPECT_TRUE(success);
-  EXPECT_EQ(node->Size(), 1);
-  EXPECT_TRUE(node->Exists("foo"));
-  EXPECT_EQ(node->GetValue("foo").ToString(), value1.ToString());
+  EXPECT_EQ(node.Size(), 1);
+  EXPECT_TRUE(node.Exists("foo"));
+  EXPECT_EQ(node.GetValue("foo").ToString(), value1.ToString());
 
   Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
-  success = node->Insert("foo", value2);
+  success = node.Insert("foo", value2);
   EXPECT_FALSE(success);
-  EXPECT_TRUE(node->Exists("foo"));
-  EXPECT_EQ(node->Size(), 1);
-  EXPECT_EQ(node->GetValue("foo").ToString(), value1.ToString());
+  EXPECT_TRUE(node.Exists("foo"));
+  EXPECT_EQ(node.Size(), 1);
+  EXPECT_EQ(node.GetValue("foo").ToString(), value1.ToString());
 
-  success = node->Insert("bar", value2);
+  success = node.Insert("bar", value2);
   EXPECT_TRUE(success);
-  EXPECT_TRUE(node->Exists("bar"));
-  EXPECT_EQ(node->Size(), 2);
-  EXPECT_EQ(node->GetValue("bar").ToString(), value2.ToString());
+  EXPECT_TRUE(node.Exists("bar"));
+  EXPECT_EQ(node.Size(), 2);
+  EXPECT_EQ(node.GetValue("bar").ToString(), value2.ToString());
 
   Value value3("Sidorov", "Sergei", "1980", "Novosibirsk", "50");
-  success = node->Insert("baz", value3);
+  success = node.Insert("baz", value3);
   EXPECT_TRUE(success);
-  EXPECT_TRUE(node->Exists("baz"));
-  EXPECT_EQ(node->Size(), 3);
-  EXPECT_EQ(node->GetValue("baz").ToString(), value3.ToString());
+  EXPECT_TRUE(node.Exists("baz"));
+  EXPECT_EQ(node.Size(), 3);
+  EXPECT_EQ(node.GetValue("baz").ToString(), value3.ToString());
 }
 
 TEST(BPlusNodeTest, SplitInternal) {
-  auto node = std::make_shared<BPlusNode>(BPlusNode::NodeType::kInternal);
-  auto child1 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  auto child2 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  auto child3 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  auto child4 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  auto child5 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  auto child6 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  child1->SetParent(node);
-  child2->SetParent(node);
-  child3->SetParent(node);
-  child4->SetParent(node);
-  child5->SetParent(node);
-  child6->SetParent(node);
-  node->SetKeys({"key3", "key5", "key7", "key9"});
-  child1->SetKeys({"key1", "key2"});
-  child2->SetKeys({"key3", "key4"});
-  child3->SetKeys({"key5", "key6"});
-  child4->SetKeys({"key7", "key8"});
-  child5->SetKeys({"key9", "key90"});
-  node->SetChildren({child1, child2, child3, child4, child5, child6});
-
-  auto new_node = node->Split();
-
-  EXPECT_EQ(node->Size(), 2u);
-  EXPECT_EQ(node->GetKeys().at(0), "key3");
-  EXPECT_EQ(node->GetKeys().at(1), "key5");
-  EXPECT_EQ(node->GetChildren().at(0), child1);
-  EXPECT_EQ(node->GetChildren().at(1), child2);
-  EXPECT_EQ(new_node->Size(), 2u);
-  EXPECT_EQ(new_node->GetKeys().at(0), "key7");
-  EXPECT_EQ(new_node->GetKeys().at(1), "key9");
-  EXPECT_EQ(new_node->GetChildren().at(0), child4);
-  EXPECT_EQ(new_node->GetChildren().at(1), child5);
+  BPlusNode node(BPlusNode::NodeType::kInternal);
+  BPlusNode child1(BPlusNode::NodeType::kLeaf);
+  BPlusNode child2(BPlusNode::NodeType::kLeaf);
+  BPlusNode child3(BPlusNode::NodeType::kLeaf);
+  BPlusNode child4(BPlusNode::NodeType::kLeaf);
+  BPlusNode child5(BPlusNode::NodeType::kLeaf);
+  BPlusNode child6(BPlusNode::NodeType::kLeaf);
+  child1.SetParent(&node);
+  child2.SetParent(&node);
+  child3.SetParent(&node);
+  child4.SetParent(&node);
+  child5.SetParent(&node);
+  child6.SetParent(&node);
+  node.SetKeys({"key3", "key5", "key7", "key9"});
+  child1.SetKeys({"key1", "key2"});
+  child2.SetKeys({"key3", "key4"});
+  child3.SetKeys({"key5", "key6"});
+  child4.SetKeys({"key7", "key8"});
+  child5.SetKeys({"key9", "key90"});
+  node.SetChildren({&child1, &child2, &child3, &child4, &child5, &child6});
+
+  BPlusNode new_node(BPlusNode::NodeType::kInternal);
+  node.Split(&new_node);
+
+  EXPECT_EQ(node.Size(), 2u);
+  EXPECT_EQ(node.GetKeys().at(0), "key3");
+  EXPECT_EQ(node.GetKeys().at(1), "key5");
+  EXPECT_EQ(node.GetChildren().at(0), &child1);
+  EXPECT_EQ(node.GetChildren().at(1), &child2);
+  EXPECT_EQ(new_node.Size(), 2u);
+  EXPECT_EQ(new_node.GetKeys().at(0), "key7");
+  EXPECT_EQ(new_node.GetKeys().at(1), "key9");
+  EXPECT_EQ(new_node.GetChildren().at(0), &child4);
+  EXPECT_EQ(new_node.GetChildren().at(1), &child5);
+  EXPECT_EQ(child4.GetParent(), &new_node);
 }
 
 TEST(BPlusNodeTest, SplitLeaf) {
-  auto node = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
+  BPlusNode node(BPlusNode::NodeType::kLeaf);
 
   Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
   Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
   Value value3("Sidorov", "Sergei", "1980", "Novosibirsk", "50");
   Value value4("Vasilev", "Vasiliy", "2002", "Moscow", "150");
 
-  node->Insert("key1", value1);
-  node->Insert("key2", value2);
-  node->Insert("key3", value3);
-  node->Insert("key4", value4);
-
-  auto new_node = node->Split();
-
-  EXPECT_EQ(node->Size(), 2u);
-  EXPECT_EQ(node->GetValue("key1").ToString(), value1.ToString());
-  EXPECT_EQ(node->GetValue("key2").ToString(), value2.ToString());
-  EXPECT_EQ(new_node->Size(), 2u);
-  EXPECT_EQ(new_node->GetValue("key3").ToString(), value3.ToString());
-  EXPECT_EQ(new_node->GetValue("key4").ToString(), value4.ToString());
+  node.Insert("key1", value1);
+  node.Insert("key2", value2);
+  node.Insert("key3", value3);
+  node.Insert("key4", value4);
+
+  BPlusNode new_node(BPlusNode::NodeType::kLeaf);
+  node.Split(&new_node);
+
+  EXPECT_EQ(node.Size(), 2u);
+  EXPECT_EQ(node.GetValue("key1").ToString(), value1.ToString());
+  EXPECT_EQ(node.GetValue("key2").ToString(), value2.ToString());
+  EXPECT_EQ(new_node.Size(), 2u);
+  EXPECT_EQ(new_node.GetValue("key3").ToString(), value3.ToString());
+  EXPECT_EQ(new_node.GetValue("key4").ToString(), value4.ToString());
+  EXPECT_EQ(node.GetNext(), &new_node);
 }
 
 TEST(BPlusNodeTest, Delete) {
-  auto node = std::make_shared<BPlusNode>(BPlusNode::NodeType::kInternal);
-  auto child1 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  auto child2 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  auto child3 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  node->Insert("key1", child1, false);
-  node->Insert("key2", child2, false);
-  node->Insert("key3", child3, false);
-
-  node->Delete("key2");
-
-  EXPECT_EQ(node->Size(), 2);
-  EXPECT_FALSE(node->Exists("key2"));
-  EXPECT_TRUE(node->Exists("key1"));
-  EXPECT_TRUE(node->Exists("key3"));
+  BPlusNode node(BPlusNode::NodeType::kInternal);
+  BPlusNode child1(BPlusNode::NodeType::kLeaf);
+  BPlusNode child2(BPlusNode::NodeType::kLeaf);
+  BPlusNode child3(BPlusNode::NodeType::kLeaf);
+  node.Insert("key1", &child1, false);
+  node.Insert("key2", &child2, false);
+  node.Insert("key3", &child3, false);
+
+  node.Delete("key2");
+
+  EXPECT_EQ(node.Size(), 2);
+  EXPECT_FALSE(node.Exists("key2"));
+  EXPECT_TRUE(node.Exists("key1"));
+  EXPECT_TRUE(node.Exists("key3"));
 }
 
 TEST(BPlusNodeTest, Remove) {
@@ -177,122 +181,284 @@ TEST(BPlusNodeTest, Remove) {
 }
 
 TEST(BPlusNodeTest, RedistributeLeaf) {
-  auto parent = std::make_shared<BPlusNode>(BPlusNode::NodeType::kInternal);
-  auto left = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  auto right = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  auto node = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
+  BPlusNode parent(BPlusNode::NodeType::kInternal);
+  BPlusNode left(BPlusNode::NodeType::kLeaf);
+  BPlusNode right(BPlusNode::NodeType::kLeaf);
+  BPlusNode node(BPlusNode::NodeType::kLeaf);
 
   Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
   Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
   Value value4("Sidorov", "Sergei", "1980", "Novosibirsk", "50");
   Value value5("Vasilev", "Vasiliy", "2002", "Moscow", "150");
-  left->Insert("key1", value1);
-  left->Insert("key2", value2);
-  right->Insert("key4", value4);
-  right->Insert("key5", value5);
-  left->SetNext(node);
-  node->SetNext(right);
-
-  left->SetParent(parent);
-  right->SetParent(parent);
-  parent->AddChild(left);
-  parent->AddKey("key3");
-  parent->AddChild(right);
-
-  node->Redistribute(right, left);
-
-  EXPECT_EQ(left->GetKeys().size(), 2);
-  EXPECT_EQ(left->GetValues().size(), 2);
-  EXPECT_EQ(left->GetKeys().at(0), "key1");
-  EXPECT_EQ(left->GetKeys().at(1), "key2");
-  EXPECT_EQ(left->GetValues().at(0).ToString(), value1.ToString());
-  EXPECT_EQ(left->GetValues().at(1).ToString(), value2.ToString());
-  EXPECT_EQ(right->GetKeys().size(), 2);
-  EXPECT_EQ(right->GetValues().size(), 2);
-  EXPECT_EQ(right->GetKeys().at(0), "key4");
-  EXPECT_EQ(right->GetKeys().at(1), "key5");
-  EXPECT_EQ(right->GetValues().at(0).ToString(), value4.ToString());
-  EXPECT_EQ(parent->GetKeys().at(0), "key3");
+  left.Insert("key1", value1);
+  left.Insert("key2", value2);
+  right.Insert("key4", value4);
+  right.Insert("key5", value5);
+  left.SetNext(&node);
+  node.SetNext(&right);
+
+  left.SetParent(&parent);
+  right.SetParent(&parent);
+  parent.AddChild(&left);
+  parent.AddKey("key3");
+  parent.AddChild(&right);
+
+  node.Redistribute(&right, &left);
+
+  EXPECT_EQ(left.GetKeys().size(), 2);
+  EXPECT_EQ(left.GetValues().size(), 2);
+  EXPECT_EQ(left.KeyAt(0), "key1");
+  EXPECT_EQ(left.KeyAt(1), "key2");
+  EXPECT_EQ(left.GetValues().at(0).ToString(), value1.ToString());
+  EXPECT_EQ(left.GetValues().at(1).ToString(), value2.ToString());
+  EXPECT_EQ(right.GetKeys().size(), 2);
+  EXPECT_EQ(right.GetValues().size(), 2);
+  EXPECT_EQ(right.KeyAt(0), "key4");
+  EXPECT_EQ(right.KeyAt(1), "key5");
+  EXPECT_EQ(right.GetValues().at(0).ToString(), value4.ToString());
+  EXPECT_EQ(parent.GetKeys().at(0), "key3");
 }
 
 TEST(BPlusNodeTest, RedistributeInternal) {
-  auto parent = std::make_shared<BPlusNode>(BPlusNode::NodeType::kInternal);
-  auto node = std::make_shared<BPlusNode>(BPlusNode::NodeType::kInternal);
-
-  parent->AddChild(node);
-  node->SetParent(parent);
-  parent->AddKey("key1");
-  node->AddKey("key2");
-
-  parent->Redistribute(node, parent);
-
-  EXPECT_EQ(parent->Size(), 1);
-  EXPECT_EQ(node->Size(), 1);
-  EXPECT_EQ(parent->GetKeys().at(0), "key1");
-  EXPECT_EQ(node->GetKeys().at(0), "key2");
-  EXPECT_EQ(parent->GetChildren().at(0), node);
-  EXPECT_EQ(node->GetParent().lock(), parent);
+  BPlusNode parent(BPlusNode::NodeType::kInternal);
+  BPlusNode node(BPlusNode::NodeType::kInternal);
+
+  parent.AddChild(&node);
+  node.SetParent(&parent);
+  parent.AddKey("key1");
+  node.AddKey("key2");
+
+  parent.Redistribute(&node, &parent);
+
+  EXPECT_EQ(parent.Size(), 1);
+  EXPECT_EQ(node.Size(), 1);
+  EXPECT_EQ(parent.GetKeys().at(0), "key1");
+  EXPECT_EQ(node.GetKeys().at(0), "key2");
+  EXPECT_EQ(parent.GetChildren().at(0), &node);
+  EXPECT_EQ(node.GetParent(), &parent);
 }
 
 TEST(BPlusNodeTest, MergeInternal) {
-  auto parent = std::make_shared<BPlusNode>(BPlusNode::NodeType::kInternal);
-  auto node1 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kInternal);
-  auto node2 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kInternal);
-  auto node3 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kInternal);
-
-  parent->Insert("key1", node1, false);
-  node1->Insert("key2", node2, false);
-  node2->Insert("key3", node3, false);
-
-  node1->Merge(node2);
-
-  EXPECT_EQ(parent->Size(), 0);
-  EXPECT_EQ(node1->Size(), 3);
-  EXPECT_EQ(node1->GetKeys().at(0), "key2");
-  EXPECT_EQ(node1->GetKeys().at(1), "key1");
-  EXPECT_EQ(node1->GetKeys().at(2), "key3");
-  EXPECT_EQ(node1->GetChildren().size(), 2);
-  EXPECT_EQ(node1->GetChildren().at(0), node2);
-  EXPECT_EQ(node1->GetChildren().at(1), node3);
-  EXPECT_EQ(node2->Size(), 1);
-  EXPECT_EQ(node2->GetChildren().at(0), node3);
+  BPlusNode parent(BPlusNode::NodeType::kInternal);
+  BPlusNode node1(BPlusNode::NodeType::kInternal);
+  BPlusNode node2(BPlusNode::NodeType::kInternal);
+  BPlusNode child1(BPlusNode::NodeType::kLeaf);
+  BPlusNode child2(BPlusNode::NodeType::kLeaf);
+  BPlusNode child3(BPlusNode::NodeType::kLeaf);
+  BPlusNode child4(BPlusNode::NodeType::kLeaf);
+
+  parent.AddChild(&node1);
+  node1.SetParent(&parent);
+  parent.Insert("key3", &node2);
+  node1.AddChild(&child1);
+  node1.Insert("key1", &child2);
+  node2.AddChild(&child3);
+  node2.Insert("key5", &child4);
+
+  node1.Merge(&node2);
+
+  EXPECT_EQ(parent.Size(), 0);
+  EXPECT_EQ(parent.GetChildren().size(), 1);
+  EXPECT_EQ(parent.GetChildren().at(0), &node1);
+  EXPECT_EQ(node1.Size(), 3);
+  EXPECT_EQ(node1.GetKeys().at(0), "key1");
+  EXPECT_EQ(node1.GetKeys().at(1), "key3");
+  EXPECT_EQ(node1.GetKeys().at(2), "key5");
+  EXPECT_EQ(node1.GetChildren().size(), 4);
+  EXPECT_EQ(node1.GetChildren().at(2), &child3);
+  EXPECT_EQ(node1.GetChildren().at(3), &child4);
+  EXPECT_EQ(child3.GetParent(), &node1);
+  EXPECT_EQ(child4.GetParent(), &node1);
 }
 
 TEST(BPlusNodeTest, MergeLeaf) {
-  auto parent = std::make_shared<BPlusNode>(BPlusNode::NodeType::kInternal);
-  auto node1 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
-  auto node2 = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
+  BPlusNode parent(BPlusNode::NodeType::kInternal);
+  BPlusNode node1(BPlusNode::NodeType::kLeaf);
+  BPlusNode node2(BPlusNode::NodeType::kLeaf);
+  BPlusNode node3(BPlusNode::NodeType::kLeaf);
 
   Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
   Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
 
-  node1->SetParent(parent);
-  parent->Insert("foo", node1, false);
-  node1->Insert("key1", value1);
-  node2->Insert("key2", value2);
-
-  node1->Merge(node2);
-
-  EXPECT_EQ(node1->Size(), 2);
-  EXPECT_TRUE(node1->Exists("key1"));
-  EXPECT_TRUE(node1->Exists("key2"));
-  EXPECT_EQ(node1->GetValues()[0].ToString(), value1.ToString());
-  EXPECT_EQ(node1->GetValues()[1].ToString(), value2.ToString());
-  EXPECT_EQ(parent->Size(), 0);
-  EXPECT_FALSE(parent->Exists("foo"));
+  node1.SetParent(&parent);
+  parent.AddChild(&node1);
+  parent.Insert("key2", &node2);
+  node1.Insert("key1", value1);
+  node2.Insert("key2", value2);
+  node1.SetNext(&node2);
+  node2.SetNext(&node3);
+
+  node1.Merge(&node2);
+
+  EXPECT_EQ(node1.Size(), 2);
+  EXPECT_TRUE(node1.Exists("key1"));
+  EXPECT_TRUE(node1.Exists("key2"));
+  EXPECT_EQ(node1.GetValues()[0].ToString(), value1.ToString());
+  EXPECT_EQ(node1.GetValues()[1].ToString(), value2.ToString());
+  EXPECT_EQ(node1.GetNext(), &node3);
+  EXPECT_EQ(parent.Size(), 0);
+  EXPECT_FALSE(parent.Exists("key2"));
+  EXPECT_EQ(parent.GetChildren().size(), 1);
 }
 
 TEST(BPlusNodeTest, GetValue) {
-  auto node = std::make_shared<BPlusNode>(BPlusNode::NodeType::kLeaf);
+  BPlusNode node(BPlusNode::NodeType::kLeaf);
 
   Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
   Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
   Value value3("Sidorov", "Sergei", "1980", "Novosibirsk", "50");
 
-  node->Insert("key1", value1);
-  node->Insert("key2", value2);
-  node->Insert("key3", value3);
+  node.Insert("key1", value1);
+  node.Insert("key2", value2);
+  node.Insert("key3", value3);
 
-  Value value = node->GetValue("key2");
+  Value value = node.GetValue("key2");
   EXPECT_EQ(value2.ToString(), value.ToString());
 }
+
+TEST(BPlusNodeTest, PrefixCompression) {
+  BPlusNode node(BPlusNode::NodeType::kLeaf);
+  Value value("Ivanov", "Ivan", "2000", "Moscow", "55");
+
+  node.Insert("org/1234/user/17", value);
+  node.Insert("org/1234/user/12", value);
+  EXPECT_EQ(node.GetPrefix(), "org/1234/user/1");
+  EXPECT_EQ(node.GetKeys(), std::vector<Key>({"2", "7"}));
+  EXPECT_EQ(node.KeyAt(1), "org/1234/user/17");
+
+  node.Insert("org/1234/group/3", value);
+  EXPECT_EQ(node.GetPrefix(), "org/1234/");
+  EXPECT_EQ(node.KeyAt(0), "org/1234/group/3");
+  EXPECT_TRUE(node.Exists("org/1234/user/12"));
+  EXPECT_FALSE(node.Exists("org/1234/"));
+  EXPECT_FALSE(node.Exists("org/1234/user/1"));
+  EXPECT_FALSE(node.Exists("2"));
+  EXPECT_FALSE(node.Insert("org/1234/user/17", value));
+  EXPECT_EQ(node.LowerBound("a"), 0u);
+  EXPECT_EQ(node.LowerBound("org/1234/user/13"), 2u);
+  EXPECT_EQ(node.UpperBound("org/1234/user/12"), 2u);
+  EXPECT_EQ(node.UpperBound("z"), 3u);
+
+  node.Insert("org/1234/user/19", value);
+  BPlusNode new_node(BPlusNode::NodeType::kLeaf);
+  node.Split(&new_node);
+  EXPECT_EQ(node.GetPrefix(), "org/1234/");
+  EXPECT_EQ(new_node.GetPrefix(), "org/1234/user/1");
+  EXPECT_EQ(new_node.GetKeys(), std::vector<Key>({"7", "9"}));
+  EXPECT_TRUE(new_node.Exists("org/1234/user/19"));
+
+  EXPECT_TRUE(node.Remove("org/1234/group/3"));
+  EXPECT_TRUE(node.Remove("org/1234/user/12"));
+  EXPECT_FALSE(node.Remove("org/1234/user/12"));
+  EXPECT_EQ(node.GetPrefix(), "");
+  EXPECT_TRUE(node.Insert("other", value));
+  EXPECT_EQ(node.GetPrefix(), "other");
+  EXPECT_EQ(node.GetValue("other").ToString(), value.ToString());
+}
+
+TEST(BPlusNodeTest, MergeCompressedLeaves) {
+  BPlusNode parent(BPlusNode::NodeType::kInternal);
+  BPlusNode node1(BPlusNode::NodeType::kLeaf);
+  BPlusNode node2(BPlusNode::NodeType::kLeaf);
+  Value value("Ivanov", "Ivan", "2000", "Moscow", "55");
+
+  node1.Insert("org/1/a", value);
+  node1.Insert("org/1/b", value);
+  node2.Insert("org/2/a", value);
+  node2.Insert("org/2/b", value);
+  node1.SetParent(&parent);
+  parent.AddChild(&node1);
+  parent.Insert(BPlusNode::Separator("org/1/b", "org/2/a"), &node2);
+  EXPECT_EQ(parent.GetKeys(), std::vector<Key>({"org/2"}));
+
+  node1.Merge(&node2);
+
+  EXPECT_EQ(node1.GetPrefix(), "org/");
+  EXPECT_EQ(node1.GetKeys(), std::vector<Key>({"1/a", "1/b", "2/a", "2/b"}));
+  EXPECT_TRUE(node1.Exists("org/2/b"));
+  EXPECT_EQ(parent.Size(), 0u);
+}
+
+TEST(BPlusNodeTest, Separator) {
+  EXPECT_EQ(BPlusNode::Separator("org/1234/user/17", "org/1234/user/2"),
+            "org/1234/user/2");
+  EXPECT_EQ(BPlusNode::Separator("org/1234/group/9", "org/1234/user/1"),
+            "org/1234/u");
+  EXPECT_EQ(BPlusNode::Separator("key", "key1"), "key1");
+  EXPECT_EQ(BPlusNode::Separator("", "b"), "b");
+}
+
+TEST(BPlusNodeTest, HeadSearch) {
+  BPlusNode node(BPlusNode::NodeType::kInternal);
+  std::vector<BPlusNode> children(20, BPlusNode(BPlusNode::NodeType::kLeaf));
+  std::vector<Key> keys = {"org/1234/user/1",
+                           "org/1234/user/10",
+                           "org/1234/user/2",
+                           "org/1234/user/2" + std::string(1, '\0'),
+                           "org/1234/user/2" + std::string(1, '\0') + "x",
+                           "org/1234/user/\xff",
+                           "org/1234/usera",
+                           "org/1234/users/12345678901",
+                           "org/1234/users/12345678902"};
+  node.AddChild(&children.back());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    node.Insert(keys[(i * 5) % keys.size()], &children[i]);
+  }
+  EXPECT_EQ(node.GetKeys(), keys);
+
+  std::vector<Key> probes = keys;
+  probes.insert(probes.end(), {"", "a", "org/1234/", "org/1234/user/",
+                               "org/1234/user/0", "org/1234/user/11",
+                               "org/1234/user/2" + std::string(2, '\0'),
+                               "org/1234/user/\x80", "org/1234/users/2", "z"});
+  for (const Key& probe : probes) {
+    EXPECT_EQ(node.LowerBound(probe),
+              std::lower_bound(keys.begin(), keys.end(), probe) - keys.begin());
+    EXPECT_EQ(node.UpperBound(probe),
+              std::upper_bound(keys.begin(), keys.end(), probe) - keys.begin());
+  }
+
+  node.SetKey(0, "a");
+  EXPECT_EQ(node.LowerBound(""), 0u);
+  EXPECT_EQ(node.LowerBound("a"), 0u);
+  EXPECT_EQ(node.UpperBound("a"), 1u);
+  EXPECT_EQ(node.LowerBound("b"), 1u);
+  EXPECT_EQ(node.LowerBound("org/1234/user/10"), 1u);
+  node.Delete("org/1234/usera");
+  EXPECT_EQ(node.LowerBound("org/1234/users/12345678902"), 7u);
+}
+
+TEST(BPlusNodeTest, HeadSearchWideNode) {
+  BPlusNode node(BPlusNode::NodeType::kInternal);
+  std::vector<BPlusNode> children(64, BPlusNode(BPlusNode::NodeType::kLeaf));
+  std::vector<Key> keys;
+  std::uint64_t state = 12345;
+  for (std::size_t i = 0; i < 63; ++i) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    Key key(8, '\0');
+    for (std::size_t b = 0; b < 8; ++b) {
+      key[b] = static_cast<char>(state >> (8 * ((b + i) % 8)));
+    }
+    keys.push_back(key);
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  node.AddChild(&children.back());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    node.Insert(keys[i], &children[i]);
+  }
+
+  std::vector<Key> probes = keys;
+  for (const Key& key : keys) {
+    Key above = key;
+    above.back() = static_cast<char>(above.back() + 1);
+    probes.push_back(above);
+    probes.push_back(key.substr(0, 4));
+  }
+  for (const Key& probe : probes) {
+    EXPECT_EQ(node.LowerBound(probe),
+              std::lower_bound(keys.begin(), keys.end(), probe) - keys.begin());
+    EXPECT_EQ(node.UpperBound(probe),
+              std::upper_bound(keys.begin(), keys.end(), probe) - keys.begin());
+  }
+}
@@ -226,3 +226,159 @@ TEST(BPlusTreeTest, Upload) {
   EXPECT_EQ(tree.Get("key3").value().ToQuotedString(), value3.ToQuotedString());
   EXPECT_EQ(tree.Get("key4").value().ToQuotedString(), value4.ToQuotedString());
 }
+
+TEST(BPlusTreeTest, KeyViewLookups) {
+  BPlusTree tree(4);
+  for (std::size_t i = 0; i < 50; ++i) {
+    tree.Set("key" + std::to_string(i), Value("Ivanov", "Ivan", "2000",
+                                              "Moscow", "55", "100"));
+  }
+  const std::string buffer = "GET key7 key42 key99\r\n";
+  KeyView key7 = KeyView(buffer).substr(4, 4);
+  KeyView key42 = KeyView(buffer).substr(9, 5);
+  KeyView key99 = KeyView(buffer).substr(15, 5);
+  EXPECT_TRUE(tree.Get(key7).has_value());
+  EXPECT_TRUE(tree.Exists(key42));
+  EXPECT_FALSE(tree.Exists(key99));
+  EXPECT_EQ(tree.TTL(key42), 100u);
+  EXPECT_TRUE(tree.Del(key42));
+  EXPECT_FALSE(tree.Del(key99));
+  EXPECT_FALSE(tree.Exists("key42"));
+  EXPECT_EQ(tree.Keys().size(), 49u);
+}
+
+TEST(BPlusTreeTest, Scan) {
+  BPlusTree tree(4);
+  for (std::size_t i = 0; i < 100; ++i) {
+    tree.Set("key" + std::to_string(i), Value());
+  }
+
+  // Leaves are merged between the calls, the key cursor stays valid.
+  std::vector<Key> scanned;
+  AbstractStore::ScanResult batch;
+  std::size_t deleted = 99;
+  do {
+    batch = tree.Scan(batch.cursor, 9);
+    EXPECT_LE(batch.keys.size(), 9u);
+    scanned.insert(scanned.end(), batch.keys.begin(), batch.keys.end());
+    tree.Del("key" + std::to_string(deleted--));
+  } while (!batch.cursor.empty());
+
+  EXPECT_TRUE(std::is_sorted(scanned.begin(), scanned.end()));
+  EXPECT_EQ(std::adjacent_find(scanned.begin(), scanned.end()), scanned.end());
+  for (std::size_t i = 0; i <= deleted; ++i) {
+    EXPECT_TRUE(std::binary_search(scanned.begin(), scanned.end(),
+                                   "key" + std::to_string(i)));
+  }
+  EXPECT_TRUE(BPlusTree(4).Scan("", 10).keys.empty());
+}
+
+TEST(BPlusTreeTest, SplitAndMergeChurn) {
+  BPlusTree tree(4);
+  std::vector<Key> expected;
+  for (std::size_t i = 0; i < 3000; ++i) {
+    EXPECT_TRUE(tree.Set(std::to_string((i * 7919) % 3000 + 10000), Value()));
+  }
+  for (std::size_t i = 0; i < 3000; ++i) {
+    std::string key = std::to_string(i + 10000);
+    if (i % 4 != 0) {
+      EXPECT_TRUE(tree.Del(key));
+    } else {
+      expected.push_back(key);
+    }
+  }
+  EXPECT_EQ(tree.Keys(), expected);
+  for (const Key& key : expected) {
+    EXPECT_TRUE(tree.Exists(key));
+    EXPECT_TRUE(tree.Del(key));
+  }
+  EXPECT_TRUE(tree.Keys().empty());
+  EXPECT_TRUE(tree.Set("key", Value()));
+  EXPECT_EQ(tree.Keys(), std::vector<Key>({"key"}));
+}
+
+TEST(BPlusTreeTest, BulkUpload) {
+  BPlusTree source(5);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    source.Set(std::to_string((i * 7919) % 1000 + 10000),
+               Value("Ivanov", "Ivan", "2000", "Moscow", std::to_string(i)));
+  }
+  EXPECT_EQ(source.Export("./bplus_bulk.dat"), 1000u);
+  {
+    std::ofstream file("./bplus_bulk_unsorted.dat");
+    file << "b \"B\" \"B\" 2000 \"City\" 1\n"
+         << "a \"A\" \"A\" 2000 \"City\" 1\n"
+         << "b \"C\" \"C\" 2000 \"City\" 1\n";
+  }
+
+  for (std::size_t degree : {3u, 4u, 5u, 10u, 64u}) {
+    for (double fill_factor : {0.5, 0.9, 1.0}) {
+      BPlusTree tree(degree, fill_factor);
+      EXPECT_EQ(tree.Upload("./bplus_bulk.dat"), 1000u);
+      EXPECT_EQ(tree.Keys(), source.Keys());
+      EXPECT_EQ(tree.Get("10500"), source.Get("10500"));
+
+      // The built tree keeps working under splits and merges.
+      for (std::size_t i = 0; i < 1000; i += 2) {
+        EXPECT_TRUE(tree.Del(std::to_string(i + 10000)));
+      }
+      EXPECT_TRUE(tree.Set("20000", Value()));
+      for (std::size_t i = 1; i < 1000; i += 2) {
+        EXPECT_TRUE(tree.Exists(std::to_string(i + 10000)));
+        EXPECT_TRUE(tree.Del(std::to_string(i + 10000)));
+      }
+      EXPECT_EQ(tree.Keys(), std::vector<Key>({"20000"}));
+    }
+  }
+
+  BPlusTree tree(4);
+  EXPECT_EQ(tree.Upload("./bplus_bulk_unsorted.dat"), 3u);
+  EXPECT_EQ(tree.Keys(), std::vector<Key>({"a", "b"}));
+  EXPECT_EQ(tree.Get("b").value().ToQuotedString(),
+            Value("B", "B", "2000", "City", "1").ToQuotedString());
+  EXPECT_EQ(tree.Upload("./bplus_bulk.dat"), 1000u);
+  EXPECT_EQ(tree.Keys().size(), 1002u);
+
+  EXPECT_THROW(BPlusTree(4, 0.0), std::invalid_argument);
+  EXPECT_THROW(BPlusTree(4, 1.5), std::invalid_argument);
+  std::remove("./bplus_bulk.dat");
+  std::remove("./bplus_bulk_unsorted.dat");
+}
+
+TEST(BPlusTreeTest, KeyRangeAndPrefix) {
+  BPlusTree tree(5);
+  for (std::size_t i = 0; i < 500; ++i) {
+    tree.Set("user:" + std::to_string(i),
+             Value("a", "b", "1990", "c", std::to_string(i)));
+    tree.Set("item:" + std::to_string(i), Value());
+  }
+  for (std::size_t i = 0; i < 500; i += 7) {
+    tree.Del("item:" + std::to_string(i));
+  }
+
+  EXPECT_EQ(tree.KeyRange("user:10", "user:102", 100),
+            std::vector<Key>({"user:10", "user:100", "user:101", "user:102"}));
+  EXPECT_EQ(tree.KeyRange("user:10", "user:102", 2),
+            std::vector<Key>({"user:10", "user:100"}));
+  EXPECT_TRUE(tree.KeyRange("user:0a", "user:0z", 10).empty());
+  EXPECT_TRUE(tree.KeyRange("user:2", "user:1", 10).empty());
+  EXPECT_EQ(tree.KeyRange("a", "z", 10000).size(), 928u);
+  EXPECT_EQ(tree.KeyRange("item:", "item:~", 10000).size(), 428u);
+
+  EXPECT_EQ(tree.PrefixRange("user:49", 100),
+            std::vector<Key>({"user:49", "user:490", "user:491", "user:492",
+                              "user:493", "user:494", "user:495", "user:496",
+                              "user:497", "user:498", "user:499"}));
+  EXPECT_EQ(tree.PrefixRange("item:", 10000).size(), 428u);
+  EXPECT_TRUE(tree.PrefixRange("none", 10).empty());
+  EXPECT_TRUE(tree.PrefixRange("zzz", 10).empty());
+
+  std::size_t visited = 0;
+  tree.ForEachWithPrefix("user:3", [&visited](const Key& key,
+                                              const Value& value) {
+    EXPECT_EQ(value.ToString(), "a b 1990 c " + key.substr(5));
+    return ++visited < 5;
+  });
+  EXPECT_EQ(visited, 5u);
+  EXPECT_TRUE(BPlusTree(4).KeyRange("a", "z", 10).empty());
+}
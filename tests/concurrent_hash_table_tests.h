@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "../hash_table/concurrent_hash_table.h"
+
+using namespace s21;
+
+TEST(ConcurrentHashTableTest, SetGetExists) {
+  ConcurrentHashTable table;
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
+
+  EXPECT_TRUE(table.Set("key1", value1));
+  EXPECT_TRUE(table.Set("key2", value2));
+  EXPECT_FALSE(table.Set("key1", value2));
+  EXPECT_EQ(table.Get("key1").value().ToString(), value1.ToString());
+  EXPECT_EQ(table.Get("unknown_key"), std::nullopt);
+  EXPECT_TRUE(table.Exists("key2"));
+  EXPECT_FALSE(table.Exists("unknown_key"));
+  EXPECT_EQ(table.Size(), 2u);
+}
+
+TEST(ConcurrentHashTableTest, DelUpdateRename) {
+  ConcurrentHashTable table;
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
+
+  table.Set("key1", value1);
+  table.Set("key2", value2);
+  EXPECT_TRUE(table.Update("key1", "- - 1999 Msk 90"));
+  EXPECT_TRUE(table.Get("key1").value().Match("Ivanov Ivan 1999 Msk 90"));
+  EXPECT_FALSE(table.Update("unknown_key", "- - - - -"));
+
+  EXPECT_TRUE(table.Rename("key2", "key3"));
+  EXPECT_FALSE(table.Rename("key1", "key3"));
+  EXPECT_FALSE(table.Rename("key2", "key4"));
+  EXPECT_EQ(table.Get("key3").value().ToString(), value2.ToString());
+
+  EXPECT_TRUE(table.Del("key1"));
+  EXPECT_FALSE(table.Del("key1"));
+  EXPECT_EQ(table.Keys(), std::vector<Key>({"key3"}));
+  EXPECT_EQ(table.Size(), 1u);
+}
+
+TEST(ConcurrentHashTableTest, FindAndTTL) {
+  ConcurrentHashTable table;
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55", "5");
+  Value value2("Ivanov", "Petr", "2000", "Moscow", "55");
+
+  table.Set("key1", value1);
+  table.Set("key2", value2);
+  EXPECT_EQ(table.Find("Ivanov - 2000 Moscow 55").size(), 2u);
+  EXPECT_EQ(table.TTL("key1"), 5u);
+  EXPECT_EQ(table.TTL("key2"), std::nullopt);
+  EXPECT_EQ(table.ShowAll().size(), 2u);
+}
+
+TEST(ConcurrentHashTableTest, ExportAndUpload) {
+  ConcurrentHashTable table;
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  table.Set("key1", value1);
+  EXPECT_EQ(table.Export("./concurrent_export.dat"), 1u);
+
+  ConcurrentHashTable uploaded;
+  EXPECT_EQ(uploaded.Upload("./concurrent_export.dat"), 1u);
+  EXPECT_EQ(uploaded.Get("key1").value().ToQuotedString(),
+            value1.ToQuotedString());
+}
+
+TEST(ConcurrentHashTableTest, ParallelWriters) {
+  ConcurrentHashTable table;
+  const std::size_t threads_cnt = 8;
+  const std::size_t keys_per_thread = 5000;
+
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < threads_cnt; ++t) {
+    threads.emplace_back([&table, t] {
+      for (std::size_t i = 0; i < keys_per_thread; ++i) {
+        table.Set("key" + std::to_string(t) + "_" + std::to_string(i),
+                  Value());
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(table.Size(), threads_cnt * keys_per_thread);
+  EXPECT_EQ(table.Keys().size(), threads_cnt * keys_per_thread);
+  for (std::size_t t = 0; t < threads_cnt; ++t) {
+    EXPECT_TRUE(table.Exists("key" + std::to_string(t) + "_0"));
+  }
+}
+
+TEST(ConcurrentHashTableTest, ReadersAndWriters) {
+  ConcurrentHashTable table;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    table.Set("stable" + std::to_string(i), Value());
+  }
+
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&table, t] {
+      for (std::size_t i = 0; i < 3000; ++i) {
+        Key key = "temp" + std::to_string(t) + "_" + std::to_string(i);
+        table.Set(key, Value());
+        table.Rename(key, key + "_renamed");
+        table.Del(key + "_renamed");
+      }
+    });
+  }
+  std::size_t missed = 0;
+  for (std::size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&table, &missed] {
+      std::size_t local_missed = 0;
+      for (std::size_t i = 0; i < 3000; ++i) {
+        if (!table.Exists("stable" + std::to_string(i % 1000))) {
+          ++local_missed;
+        }
+      }
+      static std::mutex mutex;
+      std::lock_guard<std::mutex> lock(mutex);
+      missed += local_missed;
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(missed, 0u);
+  EXPECT_EQ(table.Size(), 1000u);
+}
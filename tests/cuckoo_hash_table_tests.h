@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "../cuckoo_hash/cuckoo_hash_table.h"
+
+using namespace s21;
+
+TEST(CuckooHashTableTest, SetGetExists) {
+  CuckooHashTable table;
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
+
+  EXPECT_TRUE(table.Set("key1", value1));
+  EXPECT_TRUE(table.Set("key2", value2));
+  EXPECT_FALSE(table.Set("key1", value2));
+  EXPECT_EQ(table.Get("key1").value().ToString(), value1.ToString());
+  EXPECT_EQ(table.Get("unknown_key"), std::nullopt);
+  EXPECT_TRUE(table.Exists("key2"));
+  EXPECT_FALSE(table.Exists("unknown_key"));
+  EXPECT_EQ(table.Size(), 2u);
+}
+
+TEST(CuckooHashTableTest, DelUpdateRename) {
+  CuckooHashTable table;
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100", "10");
+
+  table.Set("key1", value1);
+  table.Set("key2", value2);
+  EXPECT_TRUE(table.Update("key1", "- - - Tver -"));
+  EXPECT_TRUE(table.Get("key1").value().Match("Ivanov Ivan 2000 Tver 55"));
+  EXPECT_FALSE(table.Update("unknown_key", "- - - Tver -"));
+  EXPECT_EQ(table.TTL("key2"), 10u);
+  EXPECT_EQ(table.TTL("key1"), std::nullopt);
+  EXPECT_FALSE(table.Rename("key1", "key2"));
+  EXPECT_TRUE(table.Rename("key1", "key3"));
+  EXPECT_FALSE(table.Exists("key1"));
+  EXPECT_TRUE(table.Get("key3").value().Match("Ivanov Ivan 2000 Tver 55"));
+  EXPECT_TRUE(table.Del("key3"));
+  EXPECT_FALSE(table.Del("key3"));
+  EXPECT_EQ(table.Size(), 1u);
+}
+
+TEST(CuckooHashTableTest, HighLoadFactor) {
+  CuckooHashTable table(4096);
+  const std::size_t capacity = table.Capacity();
+  const std::size_t count = capacity * 9 / 10;
+  for (std::size_t i = 0; i < count; ++i) {
+    EXPECT_TRUE(table.Set("key" + std::to_string(i), Value()));
+  }
+  EXPECT_EQ(table.Capacity(), capacity);
+  EXPECT_EQ(table.Size(), count);
+  for (std::size_t i = 0; i < count; ++i) {
+    EXPECT_TRUE(table.Exists("key" + std::to_string(i)));
+  }
+  EXPECT_FALSE(table.Exists("key" + std::to_string(count)));
+}
+
+TEST(CuckooHashTableTest, Grow) {
+  CuckooHashTable table;
+  for (std::size_t i = 0; i < 20000; ++i) {
+    EXPECT_TRUE(table.Set("key" + std::to_string(i), Value()));
+  }
+  for (std::size_t i = 0; i < 20000; i += 2) {
+    EXPECT_TRUE(table.Del("key" + std::to_string(i)));
+  }
+  for (std::size_t i = 0; i < 20000; ++i) {
+    EXPECT_EQ(table.Exists("key" + std::to_string(i)), i % 2 == 1);
+  }
+  EXPECT_EQ(table.Keys().size(), 10000u);
+  EXPECT_EQ(table.ShowAll().size(), 10000u);
+  EXPECT_GE(static_cast<double>(table.Size()) * 2 / table.Capacity(), 0.45);
+}
+
+TEST(CuckooHashTableTest, FindExportUpload) {
+  CuckooHashTable table;
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "Tver", "100");
+
+  table.Set("key1", value1);
+  table.Set("key2", value2);
+  table.Set("key3", value1);
+  EXPECT_EQ(table.Find("Ivanov - - - -").size(), 2u);
+  EXPECT_EQ(table.Export("./cuckoo_export.dat"), 3u);
+
+  CuckooHashTable copy;
+  EXPECT_EQ(copy.Upload("./cuckoo_export.dat"), 3u);
+  EXPECT_EQ(copy.Get("key2").value().ToString(), value2.ToString());
+  EXPECT_THROW(copy.Upload("./no_such_dir/file.dat"), std::invalid_argument);
+}
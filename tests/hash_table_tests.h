@@ -229,3 +229,268 @@ TEST(HashTableTest, Resize) {
   }
   EXPECT_EQ(table.Keys().size(), 1024u);
 }
+
+TEST(HashTableTest, IncrementalRehash) {
+  HashTable table;
+  std::size_t count = 0;
+  while (!table.IsRehashing()) {
+    table.Set("key" + std::to_string(count++), Value());
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    EXPECT_TRUE(table.Exists("key" + std::to_string(i)));
+  }
+  EXPECT_TRUE(table.Del("key0"));
+  EXPECT_TRUE(table.Rename("key1", "renamed"));
+  EXPECT_TRUE(table.Update("key2", "- - - Tver -"));
+  EXPECT_TRUE(table.IsRehashing());
+  EXPECT_EQ(table.Keys().size(), count - 1);
+
+  while (table.IsRehashing()) {
+    table.Set("key" + std::to_string(count++), Value());
+  }
+  EXPECT_FALSE(table.Exists("key0"));
+  EXPECT_FALSE(table.Exists("key1"));
+  EXPECT_TRUE(table.Exists("renamed"));
+  EXPECT_TRUE(table.Get("key2").value().Match("- - - Tver -"));
+  for (std::size_t i = 3; i < count; ++i) {
+    EXPECT_TRUE(table.Exists("key" + std::to_string(i)));
+  }
+  EXPECT_EQ(table.Keys().size(), count - 1);
+  EXPECT_EQ(table.ShowAll().size(), count - 1);
+}
+
+TEST(HashTableTest, LongSharedPrefixKeys) {
+  HashTable table;
+  const std::string prefix = "tenant:eu-central:user:" + std::string(64, 'x');
+  for (std::size_t i = 0; i < 2000; ++i) {
+    EXPECT_TRUE(table.Set(prefix + std::to_string(i), Value()));
+  }
+  for (std::size_t i = 0; i < 2000; ++i) {
+    EXPECT_TRUE(table.Exists(prefix + std::to_string(i)));
+  }
+  EXPECT_FALSE(table.Exists(prefix));
+  EXPECT_FALSE(table.Exists(prefix + "2000"));
+  EXPECT_TRUE(table.Del(prefix + "1999"));
+  EXPECT_FALSE(table.Exists(prefix + "1999"));
+  EXPECT_EQ(table.Keys().size(), 1999u);
+}
+
+TEST(HashTableTest, HashFunctions) {
+  for (const NamedHasher& named : kHashers) {
+    EXPECT_EQ(named.hasher("key"), named.hasher(std::string("key")));
+    EXPECT_NE(named.hasher("key1"), named.hasher("key2"));
+  }
+  EXPECT_NE(WyHash("key", 1), WyHash("key", 2));
+  EXPECT_NE(WyHash(std::string(100, 'a')), WyHash(std::string(101, 'a')));
+  EXPECT_EQ(FastRange(0, 256), 0u);
+  EXPECT_EQ(FastRange(~0ull, 256), 255u);
+  EXPECT_EQ(FastRange(1ull << 63, 256), 128u);
+}
+
+TEST(HashTableTest, PluggableHasher) {
+  for (const NamedHasher& named : kHashers) {
+    HashTable table(300, named.hasher);
+    for (std::size_t i = 0; i < 1000; ++i) {
+      EXPECT_TRUE(table.Set("key" + std::to_string(i), Value()));
+    }
+    for (std::size_t i = 0; i < 1000; ++i) {
+      EXPECT_TRUE(table.Exists("key" + std::to_string(i)));
+    }
+    EXPECT_FALSE(table.Exists("key1000"));
+    EXPECT_TRUE(table.Del("key500"));
+    EXPECT_EQ(table.Keys().size(), 999u);
+  }
+}
+
+TEST(HashTableTest, ChainLengths) {
+  HashTable table;
+  for (std::size_t i = 0; i < 100; ++i) {
+    table.Set("key" + std::to_string(i), Value());
+  }
+  std::vector<std::size_t> chains = table.ChainLengths();
+  std::size_t buckets = 0;
+  std::size_t records = 0;
+  for (std::size_t length = 0; length < chains.size(); ++length) {
+    buckets += chains[length];
+    records += length * chains[length];
+  }
+  EXPECT_EQ(buckets, HashTable::kDefaultCapacity);
+  EXPECT_EQ(records, 100u);
+}
+
+TEST(HashTableTest, ShrinkOnDelete) {
+  HashTable table;
+  for (std::size_t i = 0; i < 10000; ++i) {
+    table.Set("key" + std::to_string(i), Value());
+  }
+  std::size_t grown = table.Capacity();
+  EXPECT_GT(grown, HashTable::kDefaultCapacity);
+  for (std::size_t i = 0; i < 9990; ++i) {
+    EXPECT_TRUE(table.Del("key" + std::to_string(i)));
+  }
+  EXPECT_LT(table.Capacity(), grown);
+  for (std::size_t i = 9990; i < 10000; ++i) {
+    EXPECT_TRUE(table.Exists("key" + std::to_string(i)));
+  }
+  EXPECT_EQ(table.Keys().size(), 10u);
+}
+
+TEST(HashTableTest, Compact) {
+  HashTable table;
+  for (std::size_t i = 0; i < 5000; ++i) {
+    table.Set("key" + std::to_string(i), Value("Ivanov", "Ivan", "2000",
+                                               "Moscow", std::to_string(i)));
+  }
+  for (std::size_t i = 0; i < 5000; i += 2) {
+    table.Del("key" + std::to_string(i));
+  }
+  table.Compact();
+  EXPECT_FALSE(table.IsRehashing());
+  EXPECT_EQ(table.Capacity(), 8192u);
+  for (std::size_t i = 1; i < 5000; i += 2) {
+    auto value = table.Get("key" + std::to_string(i));
+    ASSERT_TRUE(value.has_value());
+    EXPECT_TRUE(value->Match("Ivanov Ivan 2000 Moscow " + std::to_string(i)));
+  }
+  EXPECT_FALSE(table.Exists("key0"));
+  EXPECT_EQ(table.Keys().size(), 2500u);
+  EXPECT_TRUE(table.Set("key0", Value()));
+}
+
+TEST(HashTableTest, MGet) {
+  HashTable table;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    table.Set("key" + std::to_string(i),
+              Value("Ivanov", "Ivan", "2000", "Moscow", std::to_string(i)));
+  }
+  std::vector<Key> keys;
+  for (std::size_t i = 0; i < 1100; i += 10) {
+    keys.push_back("key" + std::to_string(i));
+  }
+  std::vector<std::optional<Value>> values = table.MGet(keys);
+  ASSERT_EQ(values.size(), keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(values[i].has_value(), i < 100);
+    if (values[i].has_value()) {
+      EXPECT_EQ(values[i]->ToString(), table.Get(keys[i])->ToString());
+    }
+  }
+  EXPECT_TRUE(table.MGet({}).empty());
+}
+
+TEST(HashTableTest, MGetWhileRehashing) {
+  HashTable table;
+  std::size_t count = 0;
+  while (!table.IsRehashing()) {
+    table.Set("key" + std::to_string(count++), Value());
+  }
+  std::vector<Key> keys;
+  for (std::size_t i = 0; i <= count; ++i) {
+    keys.push_back("key" + std::to_string(i));
+  }
+  std::vector<std::optional<Value>> values = table.MGet(keys);
+  for (std::size_t i = 0; i < count; ++i) {
+    EXPECT_TRUE(values[i].has_value());
+  }
+  EXPECT_FALSE(values[count].has_value());
+}
+
+TEST(HashTableTest, KeyViewLookups) {
+  HashTable table;
+  for (std::size_t i = 0; i < 50; ++i) {
+    table.Set("key" + std::to_string(i), Value("Ivanov", "Ivan", "2000",
+                                               "Moscow", "55", "100"));
+  }
+  const std::string buffer = "GET key7 key42 key99\r\n";
+  KeyView key7 = KeyView(buffer).substr(4, 4);
+  KeyView key42 = KeyView(buffer).substr(9, 5);
+  KeyView key99 = KeyView(buffer).substr(15, 5);
+  EXPECT_TRUE(table.Get(key7).has_value());
+  EXPECT_TRUE(table.Exists(key42));
+  EXPECT_FALSE(table.Exists(key99));
+  EXPECT_EQ(table.TTL(key42), 100u);
+  EXPECT_TRUE(table.Del(key42));
+  EXPECT_FALSE(table.Del(key99));
+  EXPECT_FALSE(table.Exists("key42"));
+  EXPECT_EQ(table.Keys().size(), 49u);
+}
+
+TEST(HashTableTest, Scan) {
+  HashTable table;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    table.Set("key" + std::to_string(i), Value());
+  }
+
+  std::vector<Key> scanned;
+  AbstractStore::ScanResult batch;
+  std::size_t calls = 0;
+  do {
+    batch = table.Scan(batch.cursor, 10);
+    EXPECT_LE(batch.keys.size(), 10u + 10u);
+    scanned.insert(scanned.end(), batch.keys.begin(), batch.keys.end());
+    ++calls;
+  } while (!batch.cursor.empty());
+  EXPECT_GT(calls, 50u);
+
+  std::vector<Key> keys = table.Keys();
+  std::sort(scanned.begin(), scanned.end());
+  std::sort(keys.begin(), keys.end());
+  EXPECT_EQ(scanned, keys);
+  EXPECT_THROW(table.Scan("not a cursor", 10), std::invalid_argument);
+  EXPECT_TRUE(table.HasBoundedScan());
+}
+
+TEST(HashTableTest, ScanAcrossResizes) {
+  HashTable table;
+  for (std::size_t i = 0; i < 300; ++i) {
+    table.Set("key" + std::to_string(i), Value());
+  }
+
+  // The table grows and starts rehashing between the calls; every key that
+  // stays in the table must be returned exactly once.
+  std::vector<Key> scanned;
+  AbstractStore::ScanResult batch;
+  std::size_t extra = 0;
+  do {
+    batch = table.Scan(batch.cursor, 5);
+    scanned.insert(scanned.end(), batch.keys.begin(), batch.keys.end());
+    for (std::size_t i = 0; i < 20; ++i) {
+      table.Set("extra" + std::to_string(extra++), Value());
+    }
+  } while (!batch.cursor.empty());
+
+  std::sort(scanned.begin(), scanned.end());
+  EXPECT_EQ(std::adjacent_find(scanned.begin(), scanned.end()), scanned.end());
+  for (std::size_t i = 0; i < 300; ++i) {
+    EXPECT_TRUE(std::binary_search(scanned.begin(), scanned.end(),
+                                   "key" + std::to_string(i)));
+  }
+}
+
+TEST(HashTableTest, RankSelectRange) {
+  HashTable table;
+  for (std::size_t i = 0; i < 100; ++i) {
+    table.Set(std::to_string(100 + i), Value());
+  }
+
+  EXPECT_EQ(table.Rank("100"), 0u);
+  EXPECT_EQ(table.Rank("142"), 42u);
+  EXPECT_EQ(table.Rank("99"), std::nullopt);
+  EXPECT_EQ(table.Select(99), "199");
+  EXPECT_EQ(table.Select(100), std::nullopt);
+  EXPECT_EQ(table.Range(97, 10), std::vector<Key>({"197", "198", "199"}));
+  EXPECT_TRUE(table.Range(100, 10).empty());
+}
+
+TEST(HashTableTest, KeyRangeAndPrefix) {
+  HashTable table;
+  for (std::size_t i = 0; i < 100; ++i) {
+    table.Set("key" + std::to_string(i), Value());
+  }
+
+  EXPECT_EQ(table.KeyRange("key10", "key12", 10),
+            std::vector<Key>({"key10", "key11", "key12"}));
+  EXPECT_EQ(table.PrefixRange("key9", 3),
+            std::vector<Key>({"key9", "key90", "key91"}));
+  EXPECT_TRUE(table.PrefixRange("none", 10).empty());
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include "../common/object_pool.h"
+
+using namespace s21;
+
+TEST(ObjectPoolTest, CreateAndDestroy) {
+  ObjectPool<std::string> pool(4);
+  std::vector<std::string*> objects;
+  for (int i = 0; i < 10; ++i) {
+    objects.push_back(pool.Create("value" + std::to_string(i)));
+  }
+  EXPECT_EQ(pool.Size(), 10u);
+  EXPECT_EQ(pool.Slabs(), 3u);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(*objects[i], "value" + std::to_string(i));
+  }
+  for (std::string* object : objects) {
+    pool.Destroy(object);
+  }
+  EXPECT_EQ(pool.Size(), 0u);
+}
+
+TEST(ObjectPoolTest, ReuseFreedCells) {
+  ObjectPool<std::string> pool(2);
+  std::string* first = pool.Create("first");
+  std::string* second = pool.Create("second");
+  pool.Destroy(first);
+  std::string* third = pool.Create("third");
+  EXPECT_EQ(third, first);
+  EXPECT_EQ(*third, "third");
+  EXPECT_EQ(pool.Slabs(), 1u);
+  pool.Destroy(second);
+  pool.Destroy(third);
+}
+
+TEST(ObjectPoolTest, Move) {
+  ObjectPool<std::string> pool;
+  std::string* object = pool.Create("value");
+  ObjectPool<std::string> moved(std::move(pool));
+  EXPECT_EQ(moved.Size(), 1u);
+  EXPECT_EQ(pool.Size(), 0u);
+  EXPECT_EQ(*object, "value");
+  moved.Destroy(object);
+  std::string* reused = pool.Create("new");
+  EXPECT_EQ(*reused, "new");
+  EXPECT_EQ(pool.Slabs(), 1u);
+  pool.Destroy(reused);
+}
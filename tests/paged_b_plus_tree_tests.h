@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <set>
+
+#include "../paged_b_plus_tree/paged_b_plus_tree.h"
+
+using namespace s21;
+
+TEST(PagedBPlusTreeTest, SetGetDel) {
+  std::remove("./paged_basic.db");
+  {
+    PagedBPlusTree tree("./paged_basic.db");
+
+    Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+    Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100", "10");
+
+    EXPECT_TRUE(tree.Set("key1", value1));
+    EXPECT_TRUE(tree.Set("key2", value2));
+    EXPECT_FALSE(tree.Set("key1", value2));
+    EXPECT_EQ(tree.Get("key1"), value1);
+    EXPECT_EQ(tree.Get("unknown_key"), std::nullopt);
+    EXPECT_TRUE(tree.Exists("key2"));
+    EXPECT_EQ(tree.TTL("key2"), 10u);
+    EXPECT_EQ(tree.TTL("key1"), std::nullopt);
+
+    EXPECT_TRUE(tree.Update("key1", "- - - Tver -"));
+    EXPECT_TRUE(tree.Get("key1").value().Match("Ivanov Ivan 2000 Tver 55"));
+    EXPECT_FALSE(tree.Update("unknown_key", "- - - Tver -"));
+    EXPECT_FALSE(tree.Rename("key1", "key2"));
+    EXPECT_TRUE(tree.Rename("key1", "key3"));
+    EXPECT_EQ(tree.Find("Ivanov - - - -"), std::vector<Key>({"key3"}));
+    EXPECT_TRUE(tree.Del("key3"));
+    EXPECT_FALSE(tree.Del("key3"));
+    EXPECT_EQ(tree.Keys(), std::vector<Key>({"key2"}));
+    EXPECT_EQ(tree.Size(), 1u);
+  }
+  std::remove("./paged_basic.db");
+}
+
+TEST(PagedBPlusTreeTest, SmallPoolEvictsAndWritesBack) {
+  std::remove("./paged_pool.db");
+  std::set<Key> expected;
+  Value value("Ivanov", "Ivan", "2000", "Moscow", "55");
+  {
+    PagedBPlusTree tree("./paged_pool.db", BufferPool::kMinFrames);
+    for (std::size_t i = 0; i < 20000; ++i) {
+      Key key = "key" + std::to_string((i * 7919) % 20000);
+      EXPECT_TRUE(tree.Set(key, value));
+      expected.insert(key);
+    }
+    for (std::size_t i = 0; i < 20000; i += 3) {
+      Key key = "key" + std::to_string(i);
+      EXPECT_TRUE(tree.Del(key));
+      expected.erase(key);
+    }
+    EXPECT_EQ(tree.Keys(), std::vector<Key>(expected.begin(), expected.end()));
+    EXPECT_EQ(tree.Size(), expected.size());
+    EXPECT_GT(tree.GetPool().PageCount(), BufferPool::kMinFrames);
+    EXPECT_GT(tree.GetPool().Misses(), 0u);
+  }
+
+  PagedBPlusTree tree("./paged_pool.db", BufferPool::kMinFrames);
+  EXPECT_EQ(tree.Keys(), std::vector<Key>(expected.begin(), expected.end()));
+  EXPECT_EQ(tree.Get("key1"), value);
+  EXPECT_FALSE(tree.Exists("key0"));
+
+  std::size_t pages = tree.GetPool().PageCount();
+  for (const Key& key : expected) {
+    EXPECT_TRUE(tree.Del(key));
+  }
+  EXPECT_TRUE(tree.Keys().empty());
+  for (const Key& key : expected) {
+    EXPECT_TRUE(tree.Set(key, value));
+  }
+  EXPECT_EQ(tree.GetPool().PageCount(), pages);
+  std::remove("./paged_pool.db");
+}
+
+TEST(PagedBPlusTreeTest, ReopenKeepsValues) {
+  std::remove("./paged_reopen.db");
+  {
+    PagedBPlusTree tree("./paged_reopen.db");
+    tree.Set("alive", Value("Ivanov", "Ivan", "2000", "Moscow", "55", "100"));
+    tree.Set("gone", Value("Petrov", "Petr", "1990", "Tver", "10"));
+    tree.Del("gone");
+    tree.Flush();
+  }
+
+  PagedBPlusTree tree("./paged_reopen.db");
+  EXPECT_EQ(tree.Size(), 1u);
+  EXPECT_FALSE(tree.Exists("gone"));
+  std::optional<std::size_t> ttl = tree.TTL("alive");
+  ASSERT_TRUE(ttl.has_value());
+  EXPECT_LE(*ttl, 100u);
+  EXPECT_GE(*ttl, 90u);
+  std::remove("./paged_reopen.db");
+}
+
+TEST(PagedBPlusTreeTest, ScanAndRanges) {
+  std::remove("./paged_scan.db");
+  {
+    PagedBPlusTree tree("./paged_scan.db", BufferPool::kMinFrames);
+    std::vector<Key> expected;
+    for (std::size_t i = 0; i < 3000; ++i) {
+      Key key = "user:" + std::to_string(10000 + i);
+      tree.Set(key, Value("Ivanov", "Ivan", "2000", "Moscow", "55"));
+      expected.push_back(key);
+    }
+
+    std::vector<Key> scanned;
+    AbstractStore::ScanResult batch;
+    do {
+      batch = tree.Scan(batch.cursor, 128);
+      scanned.insert(scanned.end(), batch.keys.begin(), batch.keys.end());
+    } while (!batch.cursor.empty());
+    EXPECT_EQ(scanned, expected);
+
+    std::vector<Key> range;
+    tree.ForEachInRange("user:10100", "user:10109",
+                        [&range](const Key& key, const Value&) {
+                          range.push_back(key);
+                          return true;
+                        });
+    EXPECT_EQ(range, std::vector<Key>(expected.begin() + 100,
+                                      expected.begin() + 110));
+    EXPECT_EQ(tree.PrefixRange("user:1299", 100).size(), 10u);
+    EXPECT_EQ(tree.Rank("user:10500"), 500u);
+  }
+  std::remove("./paged_scan.db");
+}
+
+TEST(PagedBPlusTreeTest, RecordsOfDifferentSizes) {
+  std::remove("./paged_sizes.db");
+  {
+    PagedBPlusTree tree("./paged_sizes.db", BufferPool::kMinFrames);
+    for (std::size_t i = 0; i < 500; ++i) {
+      Key key(1 + (i * 37) % 400, 'a' + i % 26);
+      key += std::to_string(i);
+      EXPECT_TRUE(tree.Set(key, Value("Ivanov", "Ivan", "2000", "Moscow",
+                                      std::to_string(i))));
+    }
+    EXPECT_EQ(tree.Size(), 500u);
+    std::vector<Key> keys = tree.Keys();
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+
+    Key huge(PagedBPlusTree::kMaxRecordSize, 'x');
+    EXPECT_THROW(tree.Set(huge, Value()), std::length_error);
+    EXPECT_THROW(tree.Rename(keys.front(), huge), std::length_error);
+    EXPECT_TRUE(tree.Exists(keys.front()));
+    EXPECT_EQ(tree.Size(), 500u);
+  }
+  std::remove("./paged_sizes.db");
+}
+
+TEST(PagedBPlusTreeTest, InvalidFiles) {
+  EXPECT_THROW(PagedBPlusTree("./no_such_dir/file.db"), std::invalid_argument);
+  EXPECT_THROW(PagedBPlusTree("./paged_frames.db", 1), std::invalid_argument);
+
+  std::ofstream("./paged_text.db") << "not a data file\n";
+  EXPECT_THROW(PagedBPlusTree("./paged_text.db"), std::runtime_error);
+  std::remove("./paged_text.db");
+  std::remove("./paged_frames.db");
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include "../persistent_tree/persistent_tree.h"
+
+using namespace s21;
+
+TEST(PersistentTreeTest, SetGetDel) {
+  PersistentTree tree;
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100", "10");
+
+  EXPECT_TRUE(tree.Set("key1", value1));
+  EXPECT_TRUE(tree.Set("key2", value2));
+  EXPECT_FALSE(tree.Set("key1", value2));
+  EXPECT_EQ(tree.Get("key1"), value1);
+  EXPECT_EQ(tree.Get("unknown_key"), std::nullopt);
+  EXPECT_TRUE(tree.Exists("key2"));
+  EXPECT_EQ(tree.TTL("key2"), 10u);
+  EXPECT_EQ(tree.TTL("key1"), std::nullopt);
+
+  EXPECT_TRUE(tree.Update("key1", "- - - Tver -"));
+  EXPECT_TRUE(tree.Get("key1").value().Match("Ivanov Ivan 2000 Tver 55"));
+  EXPECT_FALSE(tree.Update("unknown_key", "- - - Tver -"));
+  EXPECT_FALSE(tree.Rename("key1", "key2"));
+  EXPECT_TRUE(tree.Rename("key1", "key3"));
+  EXPECT_EQ(tree.Find("Ivanov - - - -"), std::vector<Key>({"key3"}));
+  EXPECT_TRUE(tree.Del("key3"));
+  EXPECT_FALSE(tree.Del("key3"));
+  EXPECT_EQ(tree.Keys(), std::vector<Key>({"key2"}));
+}
+
+TEST(PersistentTreeTest, KeysStayOrdered) {
+  PersistentTree tree;
+  std::vector<Key> expected;
+  for (std::size_t i = 0; i < 2000; ++i) {
+    std::string key = std::to_string((i * 7919) % 2000 + 10000);
+    EXPECT_TRUE(tree.Set(key, Value()));
+  }
+  for (std::size_t i = 0; i < 2000; ++i) {
+    std::string key = std::to_string(i + 10000);
+    if (i % 3 == 0) {
+      EXPECT_TRUE(tree.Del(key));
+    } else {
+      expected.push_back(key);
+    }
+  }
+  EXPECT_EQ(tree.Keys(), expected);
+
+  std::vector<Key> scanned;
+  AbstractStore::ScanResult batch;
+  do {
+    batch = tree.Scan(batch.cursor, 100);
+    scanned.insert(scanned.end(), batch.keys.begin(), batch.keys.end());
+  } while (!batch.cursor.empty());
+  EXPECT_EQ(scanned, expected);
+}
+
+TEST(PersistentTreeTest, SnapshotIsolation) {
+  PersistentTree tree;
+  Value value("Ivanov", "Ivan", "2000", "Moscow", "55");
+  for (std::size_t i = 0; i < 100; ++i) {
+    tree.Set("key" + std::to_string(i), value);
+  }
+
+  PersistentTree::Snapshot snapshot = tree.TakeSnapshot();
+  tree.Del("key1");
+  tree.Set("new", value);
+  tree.Update("key2", "- - - Tver -");
+  tree.Rename("key3", "renamed");
+
+  EXPECT_TRUE(snapshot.Exists("key1"));
+  EXPECT_FALSE(snapshot.Exists("new"));
+  EXPECT_EQ(snapshot.Get("key2"), value);
+  EXPECT_TRUE(snapshot.Exists("key3"));
+  EXPECT_EQ(snapshot.Keys().size(), 100u);
+  EXPECT_FALSE(tree.Exists("key1"));
+  EXPECT_TRUE(tree.Get("key2").value().Match("Ivanov Ivan 2000 Tver 55"));
+
+  AbstractStore& view = snapshot;
+  EXPECT_FALSE(view.Set("other", value));
+  EXPECT_FALSE(view.Del("key1"));
+  EXPECT_FALSE(view.Update("key1", "- - - Tver -"));
+  EXPECT_FALSE(view.Rename("key1", "other"));
+  EXPECT_THROW(view.Upload("./persistent_export.dat"), std::logic_error);
+  EXPECT_EQ(view.Export("./persistent_export.dat"), 100u);
+  EXPECT_EQ(view.Rank("key10"), 2u);
+
+  PersistentTree copy;
+  EXPECT_EQ(copy.Upload("./persistent_export.dat"), 100u);
+  EXPECT_EQ(copy.Keys(), snapshot.Keys());
+  EXPECT_THROW(copy.Upload("./no_such_dir/file.dat"), std::invalid_argument);
+}
+
+TEST(PersistentTreeTest, ReadersDuringWrites) {
+  PersistentTree tree;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    tree.Set("key" + std::to_string(i), Value());
+  }
+
+  std::atomic<bool> done(false);
+  std::thread writer([&tree, &done] {
+    for (std::size_t i = 0; i < 2000; ++i) {
+      tree.Set("new" + std::to_string(i), Value());
+      tree.Del("key" + std::to_string(i % 1000));
+      tree.Set("key" + std::to_string(i % 1000), Value());
+    }
+    done = true;
+  });
+
+  std::size_t checks = 0;
+  while (!done or checks == 0) {
+    PersistentTree::Snapshot snapshot = tree.TakeSnapshot();
+    std::vector<Key> keys = snapshot.Keys();
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+    EXPECT_EQ(keys, snapshot.Keys());
+    ++checks;
+  }
+  writer.join();
+  EXPECT_EQ(tree.Keys().size(), 3000u);
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+
+#include "../avl_tree/self_balancing_binary_search_tree.h"
+#include "../sharded_store/sharded_store.h"
+
+using namespace s21;
+
+TEST(ShardedStoreTest, SetGetExistsDel) {
+  ShardedStore store(4);
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
+
+  EXPECT_EQ(store.Shards(), 4u);
+  EXPECT_TRUE(store.Set("key1", value1));
+  EXPECT_TRUE(store.Set("key2", value2));
+  EXPECT_FALSE(store.Set("key1", value2));
+  EXPECT_EQ(store.Get("key1").value().ToString(), value1.ToString());
+  EXPECT_EQ(store.Get("unknown_key"), std::nullopt);
+  EXPECT_TRUE(store.Exists("key2"));
+  EXPECT_TRUE(store.Update("key2", "- - - Tver -"));
+  EXPECT_TRUE(store.Get("key2").value().Match("Petrov Petr 1990 Tver 100"));
+  EXPECT_TRUE(store.Del("key2"));
+  EXPECT_FALSE(store.Del("key2"));
+  EXPECT_FALSE(store.Exists("key2"));
+}
+
+TEST(ShardedStoreTest, RenameAcrossShards) {
+  ShardedStore store(8);
+  Value value("Ivanov", "Ivan", "2000", "Moscow", "55");
+
+  EXPECT_TRUE(store.Set("key0", value));
+  std::size_t i = 1;
+  while (store.ShardOf("key" + std::to_string(i)) == store.ShardOf("key0")) {
+    ++i;
+  }
+  std::string other = "key" + std::to_string(i);
+  EXPECT_TRUE(store.Rename("key0", other));
+  EXPECT_FALSE(store.Exists("key0"));
+  EXPECT_EQ(store.Get(other).value().ToString(), value.ToString());
+
+  EXPECT_TRUE(store.Set("key0", value));
+  EXPECT_FALSE(store.Rename("key0", other));
+  EXPECT_FALSE(store.Rename("unknown_key", "key_new"));
+  EXPECT_TRUE(store.Exists("key0"));
+}
+
+TEST(ShardedStoreTest, FanOut) {
+  ShardedStore store(4);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    std::string city = i % 2 ? "Moscow" : "Tver";
+    std::optional<std::string> ttl =
+        i % 10 == 0 ? std::make_optional<std::string>("100") : std::nullopt;
+    store.Set("key" + std::to_string(i),
+              Value("Ivanov", "Ivan", "2000", city, "55", ttl));
+  }
+
+  std::vector<Key> keys = store.Keys();
+  std::vector<Value> values = store.ShowAll();
+  ASSERT_EQ(keys.size(), 1000u);
+  ASSERT_EQ(values.size(), 1000u);
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(store.Get(keys[i])->ToString(), values[i].ToString());
+  }
+  EXPECT_EQ(store.Find("- - - Moscow -").size(), 500u);
+  EXPECT_EQ(store.TTL("key10"), 100u);
+  store.DeleteExpiredElements();
+  EXPECT_EQ(store.Keys().size(), 1000u);
+
+  std::vector<std::optional<Value>> batch =
+      store.MGet({"key3", "key1000", "key7"});
+  ASSERT_EQ(batch.size(), 3u);
+  EXPECT_TRUE(batch[0].has_value());
+  EXPECT_FALSE(batch[1].has_value());
+  EXPECT_TRUE(batch[2]->Match("Ivanov Ivan 2000 Moscow 55"));
+}
+
+TEST(ShardedStoreTest, ExportUpload) {
+  ShardedStore store(3);
+  for (std::size_t i = 0; i < 100; ++i) {
+    store.Set("key" + std::to_string(i),
+              Value("Ivanov", "Ivan", "2000", "Moscow", std::to_string(i)));
+  }
+  EXPECT_EQ(store.Export("./sharded_export.dat"), 100u);
+
+  ShardedStore copy(5);
+  EXPECT_EQ(copy.Upload("./sharded_export.dat"), 100u);
+  for (std::size_t i = 0; i < 100; ++i) {
+    std::string key = "key" + std::to_string(i);
+    EXPECT_EQ(copy.Get(key)->ToString(), store.Get(key)->ToString());
+  }
+  EXPECT_THROW(copy.Upload("./no_such_dir/file.dat"), std::invalid_argument);
+}
+
+TEST(ShardedStoreTest, CustomInnerStore) {
+  ShardedStore store(
+      2, [] { return std::make_unique<SelfBalancingBinarySearchTree>(); });
+  for (std::size_t i = 0; i < 100; ++i) {
+    EXPECT_TRUE(store.Set("key" + std::to_string(i), Value()));
+  }
+  EXPECT_EQ(store.Keys().size(), 100u);
+  EXPECT_TRUE(store.Del("key50"));
+  EXPECT_FALSE(store.Exists("key50"));
+}
+
+TEST(ShardedStoreTest, FailingFactory) {
+  std::size_t built = 0;
+  auto factory = [&built]() -> std::unique_ptr<AbstractStore> {
+    if (++built == 3) throw std::runtime_error("no store");
+    return std::make_unique<HashTable>();
+  };
+  EXPECT_THROW(ShardedStore(4, factory), std::runtime_error);
+}
+
+TEST(ShardedStoreTest, ConcurrentClients) {
+  ShardedStore store(4);
+  Value value("Ivanov", "Ivan", "2000", "Moscow", "55");
+
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&store, &value, t] {
+      for (std::size_t i = 0; i < 500; ++i) {
+        std::string key = "key" + std::to_string(t) + "_" + std::to_string(i);
+        store.Set(key, value);
+        store.Get(key);
+        if (i % 2 == 0) store.Del(key);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(store.Keys().size(), 1000u);
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+
+#include "../swiss_table/swiss_table.h"
+
+using namespace s21;
+
+TEST(SwissTableTest, Set) {
+  SwissTable table;
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
+  Value value3("Sidorov", "Sergei", "1980", "Novosibirsk", "50");
+  Value value4("Vasilev", "Vasiliy", "2002", "Moscow", "150");
+
+  EXPECT_TRUE(table.Set("key1", value1));
+  EXPECT_TRUE(table.Set("key2", value2));
+  EXPECT_TRUE(table.Set("key3", value3));
+  EXPECT_FALSE(table.Set("key1", value4));
+  EXPECT_EQ(table.Size(), 3u);
+}
+
+TEST(SwissTableTest, Get) {
+  SwissTable table;
+  Value value("Vasilev", "Ivan", "2000", "Moscow", "55");
+  table.Set("key", value);
+
+  auto result = table.Get("key");
+  EXPECT_TRUE(result.has_value());
+  EXPECT_EQ(value.ToString(), result.value().ToString());
+
+  result = table.Get("unknown_key");
+  EXPECT_FALSE(result.has_value());
+}
+
+TEST(SwissTableTest, Exists) {
+  SwissTable table;
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
+  table.Set("key1", value1);
+  table.Set("key2", value2);
+
+  EXPECT_TRUE(table.Exists("key1"));
+  EXPECT_TRUE(table.Exists("key2"));
+  EXPECT_FALSE(table.Exists("unknown_key"));
+}
+
+TEST(SwissTableTest, Del) {
+  SwissTable table;
+  for (int i = 0; i < 100; ++i) {
+    table.Set("key" + std::to_string(i), Value());
+  }
+  EXPECT_TRUE(table.Del("key3"));
+  EXPECT_TRUE(table.Del("key90"));
+  EXPECT_FALSE(table.Del("key3"));
+  EXPECT_FALSE(table.Del("unknown_key"));
+
+  EXPECT_FALSE(table.Exists("key3"));
+  EXPECT_EQ(table.Get("key90"), std::nullopt);
+  EXPECT_TRUE(table.Exists("key1"));
+  EXPECT_TRUE(table.Exists("key99"));
+  EXPECT_EQ(table.Size(), 98u);
+}
+
+TEST(SwissTableTest, Update) {
+  SwissTable table;
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
+
+  table.Set("key1", value1);
+  table.Set("key2", value2);
+  EXPECT_TRUE(table.Update("key1", "- - 1999 Msk 90"));
+  EXPECT_TRUE(table.Update("key2", "- - - Msk -"));
+  EXPECT_TRUE(table.Get("key1").value().Match("Ivanov Ivan 1999 Msk 90"));
+  EXPECT_TRUE(table.Get("key2").value().Match("Petrov Petr 1990 Msk 100"));
+  EXPECT_FALSE(table.Update("unknown_key", "- - - - -"));
+}
+
+TEST(SwissTableTest, KeysAndShowAll) {
+  SwissTable table;
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
+  Value value3("Sidorov", "Sergei", "1980", "Novosibirsk", "50");
+
+  table.Set("key1", value1);
+  table.Set("key2", value2);
+  table.Set("key3", value3);
+  std::vector<Key> keys = table.Keys();
+  std::sort(keys.begin(), keys.end());
+  EXPECT_EQ(keys, std::vector<Key>({"key1", "key2", "key3"}));
+  EXPECT_EQ(table.ShowAll().size(), 3u);
+}
+
+TEST(SwissTableTest, Rename) {
+  SwissTable table;
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
+  Value value3("Sidorov", "Sergei", "1980", "Novosibirsk", "50");
+
+  table.Set("key1", value1);
+  table.Set("key2", value2);
+  table.Set("key3", value3);
+  EXPECT_TRUE(table.Rename("key3", "key5"));
+  EXPECT_FALSE(table.Rename("key1", "key2"));
+  EXPECT_FALSE(table.Rename("unknown_key", "key6"));
+  EXPECT_EQ(table.Get("key5").value().ToString(), value3.ToString());
+  EXPECT_FALSE(table.Get("key3"));
+}
+
+TEST(SwissTableTest, TTL) {
+  SwissTable table;
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55", "1");
+  Value value2("Sidorov", "Sergei", "1980", "Novosibirsk", "50");
+
+  table.Set("key1", value1);
+  table.Set("key2", value2);
+  EXPECT_EQ(table.TTL("key1"), 1u);
+  EXPECT_EQ(table.TTL("key2"), std::nullopt);
+  EXPECT_EQ(table.TTL("key3"), std::nullopt);
+}
+
+TEST(SwissTableTest, Find) {
+  SwissTable table;
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
+  Value value3("Ivanov", "Petr", "2000", "Moscow", "55");
+
+  table.Set("key1", value1);
+  table.Set("key2", value2);
+  table.Set("key3", value1);
+  table.Set("key4", value3);
+  EXPECT_EQ(table.Find("Ivanov - 2000 Moscow 55").size(), 3u);
+}
+
+TEST(SwissTableTest, ExportAndUpload) {
+  SwissTable table;
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "Tver", "100");
+
+  table.Set("key1", value1);
+  table.Set("key2", value2);
+  EXPECT_EQ(table.Export("./swiss_export.dat"), 2u);
+
+  SwissTable uploaded;
+  EXPECT_EQ(uploaded.Upload("./swiss_export.dat"), 2u);
+  EXPECT_EQ(uploaded.Get("key1").value().ToQuotedString(),
+            value1.ToQuotedString());
+  EXPECT_EQ(uploaded.Get("key2").value().ToQuotedString(),
+            value2.ToQuotedString());
+  EXPECT_THROW(uploaded.Upload("./no_such_dir/file.dat"),
+               std::invalid_argument);
+}
+
+TEST(SwissTableTest, Resize) {
+  SwissTable table;
+  for (std::size_t i = 0; i < 10000; ++i) {
+    EXPECT_TRUE(table.Set("key" + std::to_string(i), Value()));
+  }
+  EXPECT_EQ(table.Size(), 10000u);
+  EXPECT_GE(table.Capacity() * 7, table.Size() * 8);
+  for (std::size_t i = 0; i < 10000; ++i) {
+    EXPECT_TRUE(table.Exists("key" + std::to_string(i)));
+  }
+}
+
+TEST(SwissTableTest, ReuseDeletedSlots) {
+  SwissTable table;
+  std::size_t capacity = table.Capacity();
+  for (std::size_t round = 0; round < 50; ++round) {
+    for (std::size_t i = 0; i < 100; ++i) {
+      table.Set("key" + std::to_string(round * 100 + i), Value());
+    }
+    for (std::size_t i = 0; i < 100; ++i) {
+      EXPECT_TRUE(table.Del("key" + std::to_string(round * 100 + i)));
+    }
+  }
+  EXPECT_EQ(table.Size(), 0u);
+  EXPECT_EQ(table.Capacity(), capacity);
+  EXPECT_TRUE(table.Keys().empty());
+}
+
+TEST(SwissTableTest, DeleteExpiredElements) {
+  SwissTable table;
+  table.Set("key1", Value("Ivanov", "Ivan", "2000", "Moscow", "55", "0"));
+  table.Set("key2", Value("Petrov", "Petr", "1990", "Tver", "100"));
+  table.DeleteExpiredElements();
+  EXPECT_FALSE(table.Exists("key1"));
+  EXPECT_TRUE(table.Exists("key2"));
+}
+
+TEST(SwissTableTest, DefaultScan) {
+  SwissTable table;
+  for (std::size_t i = 0; i < 25; ++i) {
+    table.Set("key" + std::to_string(i), Value());
+  }
+  EXPECT_FALSE(table.HasBoundedScan());
+  std::vector<Key> scanned;
+  AbstractStore::ScanResult batch;
+  do {
+    batch = table.Scan(batch.cursor, 10);
+    scanned.insert(scanned.end(), batch.keys.begin(), batch.keys.end());
+  } while (!batch.cursor.empty());
+  EXPECT_EQ(scanned, table.Keys());
+}
@@ -2,7 +2,14 @@
 
 #include "bplus_node_tests.h"
 #include "bplus_tree_tests.h"
+#include "concurrent_hash_table_tests.h"
+#include "cuckoo_hash_table_tests.h"
 #include "hash_table_tests.h"
+#include "object_pool_tests.h"
+#include "paged_b_plus_tree_tests.h"
+#include "persistent_tree_tests.h"
+#include "sharded_store_tests.h"
+#include "swiss_table_tests.h"
 #include "tests_self_balancing_binary_search_tree.h"
 #include "value_tests.h"
 
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <thread>
@@ -367,3 +368,286 @@ TEST(AVLTreeTest, TTLTestEnd) {
   EXPECT_FALSE(avl_tree.Exists("key2"));
   EXPECT_FALSE(avl_tree.Exists("key3"));
 }
+
+TEST(AVLTreeTest, MGet) {
+  SelfBalancingBinarySearchTree avl_tree;
+
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
+
+  EXPECT_TRUE(avl_tree.Set("key1", value1));
+  EXPECT_TRUE(avl_tree.Set("key2", value2));
+  std::vector<std::optional<Value>> values =
+      avl_tree.MGet({"key2", "key3", "key1"});
+  ASSERT_EQ(values.size(), 3u);
+  EXPECT_EQ(values[0]->ToString(), value2.ToString());
+  EXPECT_FALSE(values[1].has_value());
+  EXPECT_EQ(values[2]->ToString(), value1.ToString());
+}
+
+TEST(AVLTreeTest, KeyViewLookups) {
+  SelfBalancingBinarySearchTree avl_tree;
+  for (std::size_t i = 0; i < 50; ++i) {
+    avl_tree.Set("key" + std::to_string(i), Value("Ivanov", "Ivan", "2000",
+                                                  "Moscow", "55", "100"));
+  }
+  const std::string buffer = "GET key7 key42 key99\r\n";
+  KeyView key7 = KeyView(buffer).substr(4, 4);
+  KeyView key42 = KeyView(buffer).substr(9, 5);
+  KeyView key99 = KeyView(buffer).substr(15, 5);
+  EXPECT_TRUE(avl_tree.Get(key7).has_value());
+  EXPECT_TRUE(avl_tree.Exists(key42));
+  EXPECT_FALSE(avl_tree.Exists(key99));
+  EXPECT_EQ(avl_tree.TTL(key42), 100u);
+  EXPECT_TRUE(avl_tree.Del(key42));
+  EXPECT_FALSE(avl_tree.Del(key99));
+  EXPECT_FALSE(avl_tree.Exists("key42"));
+  EXPECT_EQ(avl_tree.Keys().size(), 49u);
+}
+
+TEST(AVLTreeTest, Scan) {
+  SelfBalancingBinarySearchTree avl_tree;
+  for (std::size_t i = 0; i < 100; ++i) {
+    avl_tree.Set("key" + std::to_string(i), Value());
+  }
+
+  std::vector<Key> scanned;
+  AbstractStore::ScanResult batch;
+  do {
+    batch = avl_tree.Scan(batch.cursor, 7);
+    EXPECT_LE(batch.keys.size(), 7u);
+    scanned.insert(scanned.end(), batch.keys.begin(), batch.keys.end());
+    avl_tree.Del("key50");
+  } while (!batch.cursor.empty());
+  EXPECT_EQ(scanned, avl_tree.Keys());
+  EXPECT_EQ(scanned.size(), 99u);
+  EXPECT_THROW(avl_tree.Scan("key1", 7), std::invalid_argument);
+}
+
+TEST(AVLTreeTest, ReuseFreedNodes) {
+  SelfBalancingBinarySearchTree avl_tree;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    avl_tree.Set("key" + std::to_string(i),
+                 Value("a", "b", "1990", "c", std::to_string(i)));
+  }
+  for (std::size_t i = 0; i < 1000; i += 2) {
+    EXPECT_TRUE(avl_tree.Del("key" + std::to_string(i)));
+  }
+  for (std::size_t i = 0; i < 1000; i += 2) {
+    avl_tree.Set("new" + std::to_string(i),
+                 Value("d", "e", "2000", "f", std::to_string(i)));
+  }
+
+  EXPECT_EQ(avl_tree.Keys().size(), 1000u);
+  for (const Key& key : avl_tree.Keys()) {
+    EXPECT_GE(avl_tree.GetBalance(key), -1);
+    EXPECT_LE(avl_tree.GetBalance(key), 1);
+  }
+  EXPECT_FALSE(avl_tree.Exists("key10"));
+  EXPECT_EQ(avl_tree.Get("key11"), Value("a", "b", "1990", "c", "11"));
+  EXPECT_EQ(avl_tree.Get("new10"), Value("d", "e", "2000", "f", "10"));
+}
+
+TEST(AVLTreeTest, LargeTreeTeardown) {
+  auto avl_tree = std::make_unique<SelfBalancingBinarySearchTree>();
+  for (std::size_t i = 0; i < 200000; ++i) {
+    avl_tree->Set(std::to_string(1000000 + i), Value());
+  }
+  EXPECT_EQ(avl_tree->Keys().size(), 200000u);
+  avl_tree.reset();
+}
+
+TEST(AVLTreeTest, RenameToExistingKey) {
+  SelfBalancingBinarySearchTree avl_tree;
+  Value value1("Ivanov", "Ivan", "2000", "Moscow", "55");
+  Value value2("Petrov", "Petr", "1990", "St. Petersburg", "100");
+  EXPECT_TRUE(avl_tree.Set("key1", value1));
+  EXPECT_TRUE(avl_tree.Set("key2", value2));
+
+  EXPECT_FALSE(avl_tree.Rename("key1", "key2"));
+  EXPECT_EQ(avl_tree.Get("key1"), value1);
+  EXPECT_EQ(avl_tree.Get("key2"), value2);
+  EXPECT_TRUE(avl_tree.Rename("key1", "key1"));
+  EXPECT_EQ(avl_tree.Get("key1"), value1);
+}
+
+TEST(AVLTreeTest, MixedInsertDeleteKeepsBalance) {
+  SelfBalancingBinarySearchTree avl_tree;
+  std::vector<std::string> expected;
+  for (std::size_t i = 0; i < 2000; ++i) {
+    std::string key = std::to_string((i * 7919) % 2000 + 10000);
+    EXPECT_TRUE(avl_tree.Set(key, Value()));
+    EXPECT_FALSE(avl_tree.Set(key, Value()));
+  }
+  for (std::size_t i = 0; i < 2000; ++i) {
+    std::string key = std::to_string(i + 10000);
+    if (i % 3 == 0) {
+      EXPECT_TRUE(avl_tree.Del(key));
+      EXPECT_FALSE(avl_tree.Del(key));
+    } else if (i % 3 == 1) {
+      EXPECT_TRUE(avl_tree.Rename(key, "r" + key));
+      expected.push_back("r" + key);
+    } else {
+      expected.push_back(key);
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+
+  EXPECT_EQ(avl_tree.Keys(), expected);
+  for (const Key& key : expected) {
+    EXPECT_GE(avl_tree.GetBalance(key), -1);
+    EXPECT_LE(avl_tree.GetBalance(key), 1);
+  }
+}
+
+TEST(AVLTreeTest, RankSelectRange) {
+  SelfBalancingBinarySearchTree avl_tree;
+  for (std::size_t i = 0; i < 1000; ++i) {
+    avl_tree.Set(std::to_string((i * 7919) % 1000 + 1000), Value());
+  }
+  for (std::size_t i = 0; i < 1000; i += 4) {
+    avl_tree.Del(std::to_string(i + 1000));
+  }
+  std::vector<Key> keys = avl_tree.Keys();
+  ASSERT_EQ(keys.size(), 750u);
+
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(avl_tree.Rank(keys[i]), i);
+    EXPECT_EQ(avl_tree.Select(i), keys[i]);
+  }
+  EXPECT_EQ(avl_tree.Rank("1000"), std::nullopt);
+  EXPECT_EQ(avl_tree.Select(750), std::nullopt);
+
+  for (std::size_t offset = 0; offset < 760; offset += 37) {
+    std::vector<Key> page = avl_tree.Range(offset, 25);
+    std::size_t last = std::min<std::size_t>(offset + 25, keys.size());
+    std::vector<Key> expected;
+    if (offset < keys.size()) {
+      expected.assign(keys.begin() + offset, keys.begin() + last);
+    }
+    EXPECT_EQ(page, expected);
+  }
+  EXPECT_TRUE(avl_tree.Range(0, 0).empty());
+}
+
+TEST(AVLTreeTest, KeyRangeAndPrefix) {
+  SelfBalancingBinarySearchTree avl_tree;
+  for (std::size_t i = 0; i < 500; ++i) {
+    avl_tree.Set("user:" + std::to_string(i), Value("a", "b", "1990", "c",
+                                                    std::to_string(i)));
+    avl_tree.Set("item:" + std::to_string(i), Value());
+  }
+
+  EXPECT_EQ(avl_tree.KeyRange("user:10", "user:102", 100),
+            std::vector<Key>({"user:10", "user:100", "user:101", "user:102"}));
+  EXPECT_EQ(avl_tree.KeyRange("user:10", "user:102", 2),
+            std::vector<Key>({"user:10", "user:100"}));
+  EXPECT_EQ(avl_tree.KeyRange("user:0a", "user:0z", 10), std::vector<Key>());
+  EXPECT_TRUE(avl_tree.KeyRange("user:2", "user:1", 10).empty());
+  EXPECT_EQ(avl_tree.KeyRange("a", "z", 10000).size(), 1000u);
+
+  EXPECT_EQ(avl_tree.PrefixRange("user:49", 100),
+            std::vector<Key>({"user:49", "user:490", "user:491", "user:492",
+                              "user:493", "user:494", "user:495", "user:496",
+                              "user:497", "user:498", "user:499"}));
+  EXPECT_EQ(avl_tree.PrefixRange("item:", 10000).size(), 500u);
+  EXPECT_TRUE(avl_tree.PrefixRange("none", 10).empty());
+
+  std::size_t visited = 0;
+  avl_tree.ForEachWithPrefix("user:3", [&visited](const Key& key,
+                                                  const Value& value) {
+    EXPECT_EQ(value.ToString(), "a b 1990 c " + key.substr(5));
+    return ++visited < 5;
+  });
+  EXPECT_EQ(visited, 5u);
+}
+
+TEST(AVLTreeTest, BulkUpload) {
+  {
+    std::ofstream file("avl_bulk.dat");
+    for (std::size_t i = 0; i < 1000; ++i) {
+      std::size_t k = (i * 7919) % 1000;
+      file << "key" << k << " \"a\" \"b\" 1990 \"c\" " << k << "\n";
+    }
+    file << "key5 \"dup\" \"dup\" 2000 \"dup\" 1\n";
+  }
+
+  SelfBalancingBinarySearchTree shuffled;
+  EXPECT_EQ(shuffled.Upload("avl_bulk.dat"), 1001u);
+  EXPECT_EQ(shuffled.Keys().size(), 1000u);
+  EXPECT_EQ(shuffled.Get("key5")->ToString(), "a b 1990 c 5");
+  EXPECT_EQ(shuffled.Rank("key999"), 999u);
+  shuffled.Export("avl_bulk.dat");
+
+  SelfBalancingBinarySearchTree sorted;
+  EXPECT_EQ(sorted.Upload("avl_bulk.dat"), 1000u);
+  EXPECT_EQ(sorted.Keys(), shuffled.Keys());
+  EXPECT_EQ(sorted.ShowAll(), shuffled.ShowAll());
+  for (const Key& key : sorted.Keys()) {
+    EXPECT_GE(sorted.GetBalance(key), -1);
+    EXPECT_LE(sorted.GetBalance(key), 1);
+  }
+  EXPECT_TRUE(sorted.Set("key1000", Value()));
+  EXPECT_TRUE(sorted.Del("key500"));
+  EXPECT_EQ(sorted.Keys().size(), 1000u);
+
+  SelfBalancingBinarySearchTree merged;
+  merged.Set("extra", Value());
+  EXPECT_EQ(merged.Upload("avl_bulk.dat"), 1000u);
+  EXPECT_EQ(merged.Keys().size(), 1001u);
+  std::remove("avl_bulk.dat");
+}
+
+TEST(AVLTreeTest, UnionDifferenceIntersection) {
+  SelfBalancingBinarySearchTree live;
+  SelfBalancingBinarySearchTree staging;
+  for (std::size_t i = 0; i < 20000; ++i) {
+    live.Set("key" + std::to_string(i), Value("a", "b", "1990", "c", "1"));
+    staging.Set("key" + std::to_string(i + 10000),
+                Value("a", "b", "1990", "c", "2"));
+  }
+
+  EXPECT_EQ(live.Union(staging), 10000u);
+  EXPECT_EQ(live.Keys().size(), 30000u);
+  EXPECT_EQ(live.Get("key15000")->ToString(), "a b 1990 c 1");
+  EXPECT_EQ(live.Get("key25000")->ToString(), "a b 1990 c 2");
+  EXPECT_EQ(staging.Keys().size(), 20000u);
+
+  std::vector<Key> batch;
+  for (std::size_t i = 0; i < 40000; i += 3) {
+    batch.push_back("key" + std::to_string(i));
+  }
+  EXPECT_EQ(live.Difference(batch), 10000u);
+  EXPECT_FALSE(live.Exists("key3"));
+  EXPECT_TRUE(live.Exists("key4"));
+
+  EXPECT_EQ(live.Intersection(staging), 6666u);
+  EXPECT_EQ(live.Keys().size(), 13334u);
+  EXPECT_FALSE(live.Exists("key4"));
+  EXPECT_TRUE(live.Exists("key10001"));
+
+  std::vector<Key> keys = live.Keys();
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    EXPECT_EQ(live.Rank(keys[i]), i);
+    EXPECT_GE(live.GetBalance(keys[i]), -1);
+    EXPECT_LE(live.GetBalance(keys[i]), 1);
+  }
+  EXPECT_TRUE(live.Set("key4", Value()));
+  EXPECT_TRUE(live.Del("key10001"));
+}
+
+TEST(AVLTreeTest, SetOperationsWithBatches) {
+  SelfBalancingBinarySearchTree avl_tree;
+  EXPECT_EQ(avl_tree.Union({{"b", Value()}, {"a", Value()}, {"b", val}}), 2u);
+  EXPECT_EQ(avl_tree.Get("b"), Value());
+  EXPECT_EQ(avl_tree.Union({{"a", val}, {"c", val}}), 1u);
+  EXPECT_EQ(avl_tree.Get("a"), Value());
+  EXPECT_EQ(avl_tree.Keys(), std::vector<Key>({"a", "b", "c"}));
+
+  EXPECT_EQ(avl_tree.Difference(std::vector<Key>{"x", "b", "b"}), 1u);
+  EXPECT_EQ(avl_tree.Intersection(std::vector<Key>{"c", "y"}), 1u);
+  EXPECT_EQ(avl_tree.Keys(), std::vector<Key>({"c"}));
+  EXPECT_EQ(avl_tree.Intersection(std::vector<Key>{}), 1u);
+  EXPECT_TRUE(avl_tree.Keys().empty());
+  EXPECT_EQ(avl_tree.Union(std::vector<std::pair<Key, Value>>{}), 0u);
+}
@@ -82,3 +82,12 @@ TEST(ValueTest, Exceptions) {
   EXPECT_THROW(Value v("Ivanov", "Ivan", "aaa", "Rostov", "55", "10"),
                std::invalid_argument);
 }
+
+TEST(ValueTest, BytesRoundTrip) {
+  Value v("Ivanov", "Ivan", "2001", "Rostov", "55", "10");
+  Value copy = Value::FromBytes(v.ToBytes());
+  EXPECT_EQ(copy, v);
+  EXPECT_EQ(copy.TTL(), v.TTL());
+  EXPECT_THROW(Value::FromBytes(v.ToBytes().substr(0, 10)),
+               std::invalid_argument);
+}